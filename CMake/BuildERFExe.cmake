@@ -30,6 +30,14 @@ function(build_erf_lib erf_lib_name)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_MOISTURE)
   endif()
 
+  if(ERF_ENABLE_FAST_EOS)
+    target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_FAST_EOS)
+  endif()
+
+  if(NOT ERF_ENABLE_TKE)
+    target_compile_definitions(${erf_lib_name} PUBLIC ERF_NO_TKE)
+  endif()
+
   if(ERF_ENABLE_NETCDF)
     target_sources(${erf_lib_name} PRIVATE
                    ${SRC_DIR}/IO/NCInterface.H
@@ -40,7 +48,9 @@ function(build_erf_lib erf_lib_name)
                    ${SRC_DIR}/IO/NCPlotFile.cpp
                    ${SRC_DIR}/IO/NCCheckpoint.cpp
                    ${SRC_DIR}/IO/NCMultiFabFile.cpp
-                   ${SRC_DIR}/IO/NCColumnFile.cpp)
+                   ${SRC_DIR}/IO/NCColumnFile.cpp
+                   ${SRC_DIR}/IO/ERF_ReadWRFBdy.H
+                   ${SRC_DIR}/IO/ERF_ReadWRFBdy.cpp)
     target_compile_definitions(${erf_lib_name} PUBLIC ERF_USE_NETCDF)
   endif()
  
@@ -68,8 +78,14 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/IO/Checkpoint.cpp
        ${SRC_DIR}/IO/ERF_ReadBndryPlanes.H
        ${SRC_DIR}/IO/ERF_ReadBndryPlanes.cpp
+       ${SRC_DIR}/IO/ERF_PlotCompress.H
+       ${SRC_DIR}/IO/ERF_PlotCompress.cpp
        ${SRC_DIR}/IO/ERF_WriteBndryPlanes.H
        ${SRC_DIR}/IO/ERF_WriteBndryPlanes.cpp
+       ${SRC_DIR}/IO/ERF_WriteSubVolumes.H
+       ${SRC_DIR}/IO/ERF_WriteSubVolumes.cpp
+       ${SRC_DIR}/IO/ERF_Probes.H
+       ${SRC_DIR}/IO/ERF_Probes.cpp
        ${SRC_DIR}/IO/Plotfile.cpp
        ${SRC_DIR}/IO/writeJobInfo.cpp
        ${SRC_DIR}/SpatialStencils/Advection.cpp
@@ -80,6 +96,8 @@ function(build_erf_lib erf_lib_name)
        ${SRC_DIR}/SpatialStencils/StressTerm.H
        ${SRC_DIR}/SpatialStencils/Interpolation.cpp
        ${SRC_DIR}/SpatialStencils/ComputeTurbulentViscosity.cpp
+       ${SRC_DIR}/SpatialStencils/ComputeStrainRates.cpp
+       ${SRC_DIR}/SpatialStencils/PBLModels.cpp
        ${SRC_DIR}/SpatialStencils/MomentumToVelocity.cpp
        ${SRC_DIR}/SpatialStencils/VelocityToMomentum.cpp
        ${SRC_DIR}/TimeIntegration/ERF_MRI.H
@@ -102,8 +102,10 @@ init_custom_prob(
     // Set scalar = A_0*exp(-10r^2), where r is distance from center of domain
     state(i, j, k, RhoScalar_comp) = parms.A_0 * exp(-10.*r*r);
 
+#ifndef ERF_NO_TKE
     // Set an initial value for QKE
     state(i, j, k, RhoQKE_comp) = parms.QKE_0;
+#endif
 
 #ifdef ERF_USE_MOISTURE
     state(i, j, k, RhoQv_comp) = 0.0;
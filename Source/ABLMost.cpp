@@ -14,19 +14,32 @@ void ABLMost::update_fluxes(int lev,
     PlaneAverage vyave(&V_new, m_geom[lev], 2);
     PlaneAverage vzave(&W_new, m_geom[lev], 2);
 
-    Thave.compute_averages(ZDir(), Thave.field());
-    vxave.compute_averages(ZDir(), vxave.field());
-    vyave.compute_averages(ZDir(), vyave.field());
-    vzave.compute_averages(ZDir(), vzave.field());
+    // Construct horizontal averages of magnitude of horiz. velocity
+    VelPlaneAverage vmagave(m_geom[lev]);
+
+    // Compute the averages over the local grids, then sum them over all ranks in one message
+    Thave.compute_averages(ZDir(), Thave.field(), true);
+    vxave.compute_averages(ZDir(), vxave.field(), true);
+    vyave.compute_averages(ZDir(), vyave.field(), true);
+    vzave.compute_averages(ZDir(), vzave.field(), true);
+    vmagave.compute_hvelmag_averages(U_new,V_new, true);
+
+    amrex::Vector<amrex::Vector<amrex::Real>*> lines = {&Thave.line_average(), &vxave.line_average(),
+                                                        &vyave.line_average(), &vzave.line_average(),
+                                                        &vmagave.line_hvelmag_average()};
+    amrex::Vector<amrex::Real> buf;
+    for (auto* l : lines) buf.insert(buf.end(), l->begin(), l->end());
+    amrex::ParallelDescriptor::ReduceRealSum(buf.data(), buf.size());
+    auto it = buf.begin();
+    for (auto* l : lines) {
+        std::copy(it, it + l->size(), l->begin());
+        it += l->size();
+    }
 
     vel_mean[0] = vxave.line_average_interpolated(zref, 0);
     vel_mean[1] = vyave.line_average_interpolated(zref, 0);
     vel_mean[2] = vzave.line_average_interpolated(zref, 0);
     theta_mean  = Thave.line_average_interpolated(zref, 0);
-
-    // Construct horizontal averages of magnitude of horiz. velocity
-    VelPlaneAverage vmagave(m_geom[lev]);
-    vmagave.compute_hvelmag_averages(U_new,V_new);
     vmag_mean   = vmagave.line_hvelmag_average_interpolated(zref);
 
     constexpr amrex::Real eps = 1.0e-16;
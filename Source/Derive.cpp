@@ -131,6 +131,7 @@ erf_derscalar(
   erf_derrhodivide(bx, derfab, datfab, RhoScalar_comp);
 }
 
+#ifndef ERF_NO_TKE
 void
 erf_derKE(
   const amrex::Box& bx,
@@ -160,4 +161,5 @@ erf_derQKE(
 {
   erf_derrhodivide(bx, derfab, datfab, RhoQKE_comp);
 }
+#endif
 }
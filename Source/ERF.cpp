@@ -71,6 +71,7 @@ amrex::Real ERF::column_per       = -1.0;
 amrex::Real ERF::column_loc_x     = 0.0;
 amrex::Real ERF::column_loc_y     = 0.0;
 std::string ERF::column_file_name = "column_data.nc";
+int         ERF::column_buffer_size = 10;
 
 // 2D BndryRegister output (for ingestion by AMR-Wind)
 int         ERF::output_bndry_planes            = 0;
@@ -141,6 +142,18 @@ ERF::ERF ()
 
     flux_registers.resize(nlevs_max);
 
+    crse_mom.resize(nlevs_max);
+    crse_mom_valid.resize(nlevs_max, 0);
+    interp_face_reg.resize(nlevs_max);
+    eddyDiffs_lev.resize(nlevs_max);
+    eddyDiffs_valid.resize(nlevs_max, 0);
+    strain_lev.resize(nlevs_max);
+    strain_valid.resize(nlevs_max, 0);
+    mynn_columns_lev.resize(nlevs_max);
+    for (int lev = 0; lev < nlevs_max; ++lev) {
+        crse_mom[lev].resize(AMREX_SPACEDIM);
+    }
+
     // Initialize tagging criteria for mesh refinement
     refinement_criteria_setup();
 
@@ -160,6 +173,9 @@ ERF::ERF ()
 
 ERF::~ERF ()
 {
+#ifdef ERF_USE_NETCDF
+    flushNCColumnFile();
+#endif
 }
 
 // advance solution to final time
@@ -181,6 +197,12 @@ ERF::Evolve ()
         {
             m_r2d->read_input_files(cur_time,dt[0],m_bc_extdir_vals);
         }
+#ifdef ERF_USE_NETCDF
+        if (m_wrfbdy)
+        {
+            m_wrfbdy->read_input_files(cur_time,dt[0]);
+        }
+#endif
 
         int lev = 0;
         int iteration = 1;
@@ -210,6 +232,9 @@ ERF::Evolve ()
 
         post_timestep(step, cur_time, dt[0]);
 
+        // Print the integrated quantities of an earlier step if their reduction has arrived
+        m_sum_reduce.test();
+
 #ifdef AMREX_MEM_PROFILING
         {
             std::ostringstream ss;
@@ -221,6 +246,8 @@ ERF::Evolve ()
         if (cur_time >= stop_time - 1.e-6*dt[0]) break;
     }
 
+    m_sum_reduce.finish();
+
     if (plot_int > 0 && istep[0] > last_plot_file_step) {
         WritePlotFile();
     }
@@ -290,6 +317,25 @@ ERF::post_timestep (int nstep, Real time, Real dt_lev0)
          m_w2d->write_planes(istep[0], time, vars_new);
       }
     }
+
+    if (m_wsv)
+    {
+      for (int isamp = 0; isamp < m_wsv->num_samples(); ++isamp)
+      {
+         if (is_it_time_for_action(istep[0], time, dt_lev0, m_wsv->interval(isamp), m_wsv->per(isamp)))
+         {
+            m_wsv->write_sample(isamp, istep[0], time, grids, vars_new);
+         }
+      }
+    }
+
+    if (m_probes)
+    {
+      if (is_it_time_for_action(istep[0], time, dt_lev0, m_probes->interval(), m_probes->per()))
+      {
+         m_probes->sample(istep[0], time, grids, vars_new);
+      }
+    }
 }
 
 // This is called from main.cpp and handles all initialization, whether from start or restart
@@ -318,9 +364,11 @@ ERF::InitData ()
         const Real time = 0.0;
         InitFromScratch(time);
 
+#ifndef ERF_NO_TKE
         // For now we initialize rho_KE to 0
         for (int lev = finest_level-1; lev >= 0; --lev)
             vars_new[lev][Vars::cons].setVal(0.0,RhoKE_comp,1,0);
+#endif
 
 #ifdef ERF_USE_TERRAIN
         for (int lev = 0; lev <= finest_level; lev++)
@@ -359,6 +407,12 @@ ERF::InitData ()
         for (int lev = finest_level-1; lev >= 0; --lev)
             make_metrics(geom[lev],z_phys_nd[lev],z_phys_cc[lev],detJ_cc[lev]);
 #endif
+
+#ifdef ERF_USE_NETCDF
+        if (init_type == "real" && (!geom[0].isPeriodic(0) || !geom[0].isPeriodic(1))) {
+            read_from_wrfbdy();
+        }
+#endif
     }
 
     if (input_bndry_planes) {
@@ -425,6 +479,29 @@ ERF::InitData ()
         }
     }
 
+    // High-frequency output of planes, lines and sub-boxes
+    if (ParmParse("erf").contains("sample_names"))
+    {
+        m_wsv = std::make_unique<WriteSubVolumes>(geom);
+
+        for (int isamp = 0; isamp < m_wsv->num_samples(); ++isamp) {
+            m_wsv->write_sample(isamp, istep[0], t_new[0], grids, vars_new);
+        }
+    }
+
+    // Time series at probe points, lines and towers
+    if (ParmParse("erf").contains("probe_names"))
+    {
+        m_probes = std::make_unique<Probes>(geom);
+
+        // The interpolation stencils reach into the ghost cells, which aren't filled yet
+        //     (unless we just wrote a plotfile)
+        for (int lev = 0; lev <= finest_level; ++lev) {
+            FillPatch(lev, t_new[lev], vars_new[lev]);
+        }
+        m_probes->sample(istep[0], t_new[0], grids, vars_new);
+    }
+
     // Fill ghost cells/faces
     for (int lev = finest_level-1; lev >= 0; --lev)
     {
@@ -486,6 +563,14 @@ ERF::MakeNewLevelFromCoarse (int lev, Real time, const BoxArray& ba,
     t_new[lev] = time;
     t_old[lev] = time - 1.e200;
 
+    clear_sum_weights(lev);
+    interp_face_reg[lev].reset();
+    eddyDiffs_lev[lev].reset();
+    eddyDiffs_valid[lev] = 0;
+    strain_lev[lev].clear();
+    strain_valid[lev] = 0;
+    mynn_columns_lev[lev].reset();
+
     FillCoarsePatchAllVars(lev, time, vars_new[lev]);
 }
 
@@ -521,6 +606,14 @@ ERF::RemakeLevel (int lev, Real time, const BoxArray& ba, const DistributionMapp
 
     t_new[lev] = time;
     t_old[lev] = time - 1.e200;
+
+    clear_sum_weights(lev);
+    interp_face_reg[lev].reset();
+    eddyDiffs_lev[lev].reset();
+    eddyDiffs_valid[lev] = 0;
+    strain_lev[lev].clear();
+    strain_valid[lev] = 0;
+    mynn_columns_lev[lev].reset();
 }
 
 // Delete level data
@@ -532,6 +625,16 @@ ERF::ClearLevel (int lev)
         vars_new[lev][var_idx].clear();
         vars_old[lev][var_idx].clear();
     }
+
+    clear_sum_weights(lev);
+    interp_face_reg[lev].reset();
+    eddyDiffs_lev[lev].reset();
+    eddyDiffs_valid[lev] = 0;
+    strain_lev[lev].clear();
+    strain_valid[lev] = 0;
+    mynn_columns_lev[lev].reset();
+    crse_mom_valid[lev] = 0;
+    for (auto& mf : crse_mom[lev]) mf.clear();
 }
 
 // Make a new level from scratch using provided BoxArray and DistributionMapping.
@@ -546,6 +649,14 @@ void ERF::MakeNewLevelFromScratch (int lev, Real /*time*/, const BoxArray& ba,
     SetBoxArray(lev, ba);
     SetDistributionMap(lev, dm);
 
+    clear_sum_weights(lev);
+    interp_face_reg[lev].reset();
+    eddyDiffs_lev[lev].reset();
+    eddyDiffs_valid[lev] = 0;
+    strain_lev[lev].clear();
+    strain_valid[lev] = 0;
+    mynn_columns_lev[lev].reset();
+
     // The number of ghost cells for density must be 1 greater than that for velocity
     //     so that we can go back in forth betwen velocity and momentum on all faces
     int ngrow_state = ComputeGhostCells(solverChoice.spatial_order)+1;
@@ -584,15 +695,15 @@ void ERF::MakeNewLevelFromScratch (int lev, Real /*time*/, const BoxArray& ba,
 #endif
 
 #ifdef ERF_USE_NETCDF
-    NC_xvel_fab.resize(lev+1);
-    NC_yvel_fab.resize(lev+1);
-    NC_zvel_fab.resize(lev+1);
-    NC_rho_fab.resize(lev+1);
-    NC_rhotheta_fab.resize(lev+1);
+    NC_xvel_mf.resize(lev+1);
+    NC_yvel_mf.resize(lev+1);
+    NC_zvel_mf.resize(lev+1);
+    NC_rho_mf.resize(lev+1);
+    NC_rhotheta_mf.resize(lev+1);
 
 #ifdef ERF_USE_TERRAIN
-    NC_PH_fab.resize(lev+1);
-    NC_PHB_fab.resize(lev+1);
+    NC_PH_mf.resize(lev+1);
+    NC_PHB_mf.resize(lev+1);
 #endif
 #endif
 }
@@ -623,7 +734,7 @@ ERF::init_only(int lev, Real time)
         if (init_type == "real" && (!geom[0].isPeriodic(0) || !geom[0].isPeriodic(1))) {
             if (nc_bdy_file.empty())
                 amrex::Error("NetCDF boundary file name must be provided via input");
-            //read_from_wrfbdy(); // TODO: Uncomment after it's working correctly
+            read_from_wrfbdy();
         }
     }
 #endif //ERF_USE_NETCDF
@@ -676,7 +787,6 @@ ERF::init_only(int lev, Real time)
 #endif
         // INITIAL DATA common for "ideal" as well as "real" simulation
         for ( MFIter mfi(lev_new[Vars::cons], TilingIfNotGPU()); mfi.isValid(); ++mfi ) {
-            const Box &bx = mfi.tilebox();
             // Define fabs for holding the initial data
             FArrayBox &cons_fab = lev_new[Vars::cons][mfi];
             FArrayBox &xvel_fab = lev_new[Vars::xvel][mfi];
@@ -685,12 +795,15 @@ ERF::init_only(int lev, Real time)
 
 #ifdef ERF_USE_TERRAIN
           FArrayBox& z_phys_nd_fab = z_phys_nd[lev][mfi];
-          init_from_wrfinput(lev, bx, cons_fab, xvel_fab, yvel_fab, zvel_fab,
+          init_from_wrfinput(lev, mfi, cons_fab, xvel_fab, yvel_fab, zvel_fab,
                              z_phys_nd_fab);
 #else
-          init_from_wrfinput(bx, cons_fab, xvel_fab, yvel_fab, zvel_fab);
+          init_from_wrfinput(lev, mfi, cons_fab, xvel_fab, yvel_fab, zvel_fab);
 #endif
         }
+
+        // We no longer need the data read from the file(s)
+        clear_wrfinput_data(lev);
     } // init_type == "ideal" || init_type == "real"
 #endif //ERF_USE_NETCDF
 
@@ -847,6 +960,7 @@ ERF::ReadParameters ()
         pp.query("column_loc_x", column_loc_x);
         pp.query("column_loc_y", column_loc_y);
         pp.query("column_file_name", column_file_name);
+        pp.query("column_buffer_size", column_buffer_size);
 
         // Specify information about outputting planes of data
         pp.query("output_bndry_planes", output_bndry_planes);
@@ -879,76 +993,82 @@ ERF::MakeHorizontalAverages ()
     Real area_z = static_cast<Real>(domain.length(0));
     area_z *= domain.length(1);
 
-    // resize the level 0 horizontal average vectors
-    h_havg_density.resize(size_z, 0.0_rt);
-    h_havg_temperature.resize(size_z, 0.0_rt);
-    h_havg_pressure.resize(size_z, 0.0_rt);
 #ifdef ERF_USE_MOISTURE
-    h_havg_qv.resize(size_z, 0.0_rt);
-    h_havg_qc.resize(size_z, 0.0_rt);
+    const int ncomp = 5;
+#else
+    const int ncomp = 3;
 #endif
 
-    // get the cell centered data and construct sums
-    auto& mf_cons = vars_new[0][Vars::cons];
+    // All profiles are accumulated together, component n of level k at n*size_z + k-start_z
+    Gpu::DeviceVector<Real> d_sums(ncomp*size_z, 0.0_rt);
+    Real* sums_ptr = d_sums.data();
+
+    // get the cell centered data and construct sums in a single pass over each box
+    const auto& mf_cons = vars_new[0][Vars::cons];
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-    for (MFIter mfi(mf_cons); mfi.isValid(); ++mfi) {
-        const Box& box = mfi.validbox();
-        const IntVect& se = box.smallEnd();
-        const IntVect& be = box.bigEnd();
-        auto  arr_cons = mf_cons[mfi].array();
-
-#ifdef ERF_USE_MOISTURE
-        FArrayBox fab_reduce(box, 5);
+    {
+#ifdef AMREX_USE_GPU
+        Real* p = sums_ptr;
 #else
-        FArrayBox fab_reduce(box, 3);
+        // On the host each thread accumulates into its own profiles, combined below
+        Vector<Real> thread_sums(ncomp*size_z, 0.0_rt);
+        Real* p = thread_sums.data();
 #endif
-        Elixir elx_reduce = fab_reduce.elixir();
-        auto arr_reduce = fab_reduce.array();
-
-        ParallelFor(box, [=] AMREX_GPU_DEVICE (int i, int j, int k) {
-            Real dens = arr_cons(i, j, k, Cons::Rho);
-            arr_reduce(i, j, k, 0) = dens;
-            arr_reduce(i, j, k, 1) = arr_cons(i, j, k, Cons::RhoTheta) / dens;
-            arr_reduce(i, j, k, 2) = getPgivenRTh(arr_cons(i, j, k, Cons::RhoTheta));
+
+        for (MFIter mfi(mf_cons, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+            const Box& box = mfi.tilebox();
+            const auto arr_cons = mf_cons.const_array(mfi);
+
+            ParallelFor(box, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                Real* pk = p + (k-start_z);
+                const Real dens = arr_cons(i, j, k, Cons::Rho);
+                Gpu::Atomic::AddNoRet(pk           , dens);
+                Gpu::Atomic::AddNoRet(pk +   size_z, arr_cons(i, j, k, Cons::RhoTheta) / dens);
+                Gpu::Atomic::AddNoRet(pk + 2*size_z, getPgivenRTh(arr_cons(i, j, k, Cons::RhoTheta)));
 #ifdef ERF_USE_MOISTURE
-            arr_reduce(i, j, k, 3) = arr_cons(i, j, k, Cons::RhoQv) / dens;
-            arr_reduce(i, j, k, 4) = arr_cons(i, j, k, Cons::RhoQc) / dens;
+                Gpu::Atomic::AddNoRet(pk + 3*size_z, arr_cons(i, j, k, Cons::RhoQv) / dens);
+                Gpu::Atomic::AddNoRet(pk + 4*size_z, arr_cons(i, j, k, Cons::RhoQc) / dens);
 #endif
-        });
+            });
+        }
 
-        for (int k=se[dir_z]; k <= be[dir_z]; ++k) {
-            Box kbox(box); kbox.setSmall(dir_z,k); kbox.setBig(dir_z,k);
-            h_havg_density     [k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,0);
-            h_havg_temperature [k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,1);
-            h_havg_pressure    [k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,2);
-#ifdef ERF_USE_MOISTURE
-            h_havg_qv          [k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,3);
-            h_havg_qc          [k-start_z] += fab_reduce.sum<RunOn::Device>(kbox,4);
+#ifndef AMREX_USE_GPU
+#ifdef _OPENMP
+#pragma omp critical (erf_make_havg)
 #endif
+        for (int n = 0; n < ncomp*size_z; ++n) {
+            sums_ptr[n] += p[n];
         }
+#endif
     }
 
-    // combine sums from different MPI ranks
-    ParallelDescriptor::ReduceRealSum(h_havg_density.dataPtr(), h_havg_density.size());
-    ParallelDescriptor::ReduceRealSum(h_havg_temperature.dataPtr(), h_havg_temperature.size());
-    ParallelDescriptor::ReduceRealSum(h_havg_pressure.dataPtr(), h_havg_pressure.size());
-#ifdef ERF_USE_MOISTURE
-    ParallelDescriptor::ReduceRealSum(h_havg_qv.dataPtr(), h_havg_qv.size());
-    ParallelDescriptor::ReduceRealSum(h_havg_qc.dataPtr(), h_havg_qc.size());
-#endif
+    // combine sums from different MPI ranks in a single message
+    Vector<Real> h_sums(ncomp*size_z);
+    Gpu::copy(Gpu::deviceToHost, d_sums.begin(), d_sums.end(), h_sums.begin());
+    ParallelDescriptor::ReduceRealSum(h_sums.dataPtr(), h_sums.size());
 
     // divide by the total number of cells we are averaging over
-    for (int k = 0; k < size_z; ++k) {
-        h_havg_density[k]     /= area_z;
-        h_havg_temperature[k] /= area_z;
-        h_havg_pressure[k]    /= area_z;
+    for (auto& v : h_sums) {
+        v /= area_z;
+    }
+
+    // resize the level 0 horizontal average vectors and fill them
+    h_havg_density.resize(size_z);
+    h_havg_temperature.resize(size_z);
+    h_havg_pressure.resize(size_z);
 #ifdef ERF_USE_MOISTURE
-        h_havg_qv[k]          /= area_z;
-        h_havg_qc[k]          /= area_z;
+    h_havg_qv.resize(size_z);
+    h_havg_qc.resize(size_z);
+#endif
+    std::copy(h_sums.begin()           , h_sums.begin() +   size_z, h_havg_density.begin());
+    std::copy(h_sums.begin() +   size_z, h_sums.begin() + 2*size_z, h_havg_temperature.begin());
+    std::copy(h_sums.begin() + 2*size_z, h_sums.begin() + 3*size_z, h_havg_pressure.begin());
+#ifdef ERF_USE_MOISTURE
+    std::copy(h_sums.begin() + 3*size_z, h_sums.begin() + 4*size_z, h_havg_qv.begin());
+    std::copy(h_sums.begin() + 4*size_z, h_sums.begin() + 5*size_z, h_havg_qc.begin());
 #endif
-    }
 
     // resize device vectors
     d_havg_density.resize(size_z, 0.0_rt);
@@ -1014,261 +1134,129 @@ ERF::setupABLMost (int lev)
 void
 ERF::read_from_wrfinput(int lev)
 {
-    Box input_box;
-
-    NC_xvel_fab[lev].resize(num_boxes_at_level[lev]);
-    NC_yvel_fab[lev].resize(num_boxes_at_level[lev]);
-    NC_zvel_fab[lev].resize(num_boxes_at_level[lev]);
-    NC_rho_fab[lev].resize(num_boxes_at_level[lev]);
-    NC_rhotheta_fab[lev].resize(num_boxes_at_level[lev]);
+    // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+    if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
 
-#ifdef ERF_USE_TERRAIN
-    NC_PH_fab[lev].resize(num_boxes_at_level[lev]);
-    NC_PHB_fab[lev].resize(num_boxes_at_level[lev]);
-#endif
-
-    for (int idx = 0; idx < num_boxes_at_level[lev]; idx++)
-    {
-        if (lev == 0) {
-            input_box = geom[0].Domain();
-        } else {
-            input_box = boxes_at_level[lev][idx];
-        }
+    // The data are read into MultiFabs that live on the grids of this level (including ghost cells),
+    //    so that each rank only reads the hyperslabs of the file(s) covering its own grids
+    const BoxArray& ba            = vars_new[lev][Vars::cons].boxArray();
+    const DistributionMapping& dm = vars_new[lev][Vars::cons].DistributionMap();
 
-        // We allocate these here so they exist on all ranks
-        Box ubx(input_box); ubx.surroundingNodes(0);
-        Box vbx(input_box); vbx.surroundingNodes(1);
-        Box wbx(input_box); wbx.surroundingNodes(2);
+    const IntVect ngrow_state = vars_new[lev][Vars::cons].nGrowVect();
+    const IntVect ngrow_vels  = vars_new[lev][Vars::xvel].nGrowVect();
 
-        NC_xvel_fab[lev][idx].resize(ubx,1);
-        NC_yvel_fab[lev][idx].resize(vbx,1);
-        NC_zvel_fab[lev][idx].resize(wbx,1);
-        NC_rho_fab[lev][idx].resize(input_box,1);
-        NC_rhotheta_fab[lev][idx].resize(input_box,1);
+    NC_xvel_mf[lev].define(convert(ba, IntVect(1,0,0)), dm, 1, ngrow_vels);
+    NC_yvel_mf[lev].define(convert(ba, IntVect(0,1,0)), dm, 1, ngrow_vels);
+    NC_zvel_mf[lev].define(convert(ba, IntVect(0,0,1)), dm, 1, ngrow_vels);
+    NC_rho_mf[lev].define(ba, dm, 1, ngrow_state);
+    NC_rhotheta_mf[lev].define(ba, dm, 1, ngrow_state);
 
 #ifdef ERF_USE_TERRAIN
-        NC_PH_fab[lev][idx].resize(wbx,1);
-        NC_PHB_fab[lev][idx].resize(wbx,1);
+    // z_phys_nd (one ghost node) is built by averaging PH and PHB over the 4 surrounding z-faces
+    NC_PH_mf[lev].define(convert(ba, IntVect(0,0,1)), dm, 1, IntVect(2,2,0));
+    NC_PHB_mf[lev].define(convert(ba, IntVect(0,0,1)), dm, 1, IntVect(2,2,0));
 #endif
 
-#ifdef AMREX_USE_GPU
-        FArrayBox host_NC_xvel_fab   (NC_xvel_fab[lev][idx].box(),     NC_xvel_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-        FArrayBox host_NC_yvel_fab   (NC_yvel_fab[lev][idx].box(),     NC_yvel_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-        FArrayBox host_NC_zvel_fab   (NC_zvel_fab[lev][idx].box(),     NC_zvel_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-        FArrayBox host_NC_rho_fab    (NC_rho_fab[lev][idx].box(),      NC_rho_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-       FArrayBox host_NC_rhotheta_fab(NC_rhotheta_fab[lev][idx].box(), NC_rhotheta_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
+    // Anything not covered by an input file is zero, as before
+    NC_xvel_mf[lev].setVal(0.0);
+    NC_yvel_mf[lev].setVal(0.0);
+    NC_zvel_mf[lev].setVal(0.0);
+    NC_rho_mf[lev].setVal(0.0);
+    NC_rhotheta_mf[lev].setVal(0.0);
 #ifdef ERF_USE_TERRAIN
-        FArrayBox host_NC_PH_fab (NC_PH_fab[lev][idx].box(),  NC_PH_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-        FArrayBox host_NC_PHB_fab(NC_PHB_fab[lev][idx].box(), NC_PHB_fab[lev][idx].nComp(),amrex::The_Pinned_Arena());
-#endif
-#else
-        FArrayBox host_NC_xvel_fab    (NC_xvel_fab[lev][idx]    , amrex::make_alias, 0, NC_xvel_fab[lev][idx].nComp());
-        FArrayBox host_NC_yvel_fab    (NC_yvel_fab[lev][idx]    , amrex::make_alias, 0, NC_yvel_fab[lev][idx].nComp());
-        FArrayBox host_NC_zvel_fab    (NC_zvel_fab[lev][idx]    , amrex::make_alias, 0, NC_zvel_fab[lev][idx].nComp());
-        FArrayBox host_NC_rho_fab     (NC_rho_fab[lev][idx]     , amrex::make_alias, 0, NC_rho_fab[lev][idx].nComp());
-        FArrayBox host_NC_rhotheta_fab(NC_rhotheta_fab[lev][idx], amrex::make_alias, 0, NC_rhotheta_fab[lev][idx].nComp());
-#ifdef ERF_USE_TERRAIN
-        FArrayBox host_NC_PH_fab      (NC_PH_fab[lev][idx]      , amrex::make_alias, 0, NC_PH_fab[lev][idx].nComp());
-        FArrayBox host_NC_PHB_fab     (NC_PHB_fab[lev][idx]     , amrex::make_alias, 0, NC_PHB_fab[lev][idx].nComp());
-#endif
+    NC_PH_mf[lev].setVal(0.0);
+    NC_PHB_mf[lev].setVal(0.0);
 #endif
 
-        if (ParallelDescriptor::IOProcessor())
-        {
-            Vector<FArrayBox*> NC_fabs;
-            Vector<std::string> NC_names;
-            Vector<enum NC_Data_Dims_Type> NC_dim_types;
-
-            NC_fabs.push_back(&host_NC_xvel_fab);     NC_names.push_back("U");
-            NC_fabs.push_back(&host_NC_yvel_fab);     NC_names.push_back("V");
-            NC_fabs.push_back(&host_NC_zvel_fab);     NC_names.push_back("W");
-            NC_fabs.push_back(&host_NC_rho_fab);      NC_names.push_back("ALB");
-            NC_fabs.push_back(&host_NC_rhotheta_fab); NC_names.push_back("T_INIT");
-
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
+    Vector<std::string> NC_names;
+    Vector<MultiFab*> NC_mfs;
 
+    NC_mfs.push_back(&NC_xvel_mf[lev]);     NC_names.push_back("U");
+    NC_mfs.push_back(&NC_yvel_mf[lev]);     NC_names.push_back("V");
+    NC_mfs.push_back(&NC_zvel_mf[lev]);     NC_names.push_back("W");
+    NC_mfs.push_back(&NC_rho_mf[lev]);      NC_names.push_back("ALB");
+    NC_mfs.push_back(&NC_rhotheta_mf[lev]); NC_names.push_back("T_INIT");
 #ifdef ERF_USE_TERRAIN
-            NC_fabs.push_back(&host_NC_PH_fab);  NC_names.push_back("PH");
-            NC_fabs.push_back(&host_NC_PHB_fab); NC_names.push_back("PHB");
-
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
-            NC_dim_types.push_back(NC_Data_Dims_Type::Time_BT_SN_WE);
+    NC_mfs.push_back(&NC_PH_mf[lev]);       NC_names.push_back("PH");
+    NC_mfs.push_back(&NC_PHB_mf[lev]);      NC_names.push_back("PHB");
 #endif
+    const int irho      = 3;
+    const int irhotheta = 4;
+
+    // The FABs owned by this rank (in the same order for every variable)
+    Vector<Vector<FArrayBox*>> NC_fabs(NC_mfs.size());
+    for (MFIter mfi(NC_rho_mf[lev]); mfi.isValid(); ++mfi) {
+        for (int i = 0; i < NC_mfs.size(); i++) {
+            NC_fabs[i].push_back(&(*NC_mfs[i])[mfi]);
+        }
+    }
 
-            // Read the netcdf file and fill these FABs
-            // NOTE: right now we are hard-wired to one "domain" per level -- but that can be generalized
-            //       once we know how to determine the level for each input file
-            BuildFABsFromWRFInputFile(nc_init_file[lev][idx], NC_names, NC_fabs, NC_dim_types);
-
-        } // if ParalleDescriptor::IOProcessor()
+    for (int idx = 0; idx < num_boxes_at_level[lev]; idx++)
+    {
+        const Box input_box = (lev == 0) ? geom[0].Domain() : boxes_at_level[lev][idx];
 
-        // We put a barrier here so the rest of the processors wait to do anything until they have the data
-        amrex::ParallelDescriptor::Barrier();
+        // Read the netcdf file and fill the parts of these FABs it covers
+        // NOTE: right now we are hard-wired to one "domain" per level -- but that can be generalized
+        //       once we know how to determine the level for each input file
+        Vector<Vector<Box>> read_boxes;
+        ReadWRFInputHyperslabs(nc_init_file[lev][idx], NC_names, NC_fabs, input_box.smallEnd(), read_boxes);
 
-        // When an FArrayBox is built, space is allocated on every rank.  However, we only
-        //    filled the data in these FABs on the IOProcessor.  So here we broadcast
-        //    the data to every rank.
+        for (int n = 0; n < NC_fabs[irho].size(); n++)
+        {
+            const Box& bx = read_boxes[irho][n];
+            if (!bx.ok()) continue;
 
-        int ioproc = ParallelDescriptor::IOProcessorNumber();  // I/O rank
-        ParallelDescriptor::Bcast(host_NC_xvel_fab.dataPtr(),NC_xvel_fab[lev][idx].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(host_NC_yvel_fab.dataPtr(),NC_yvel_fab[lev][idx].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(host_NC_zvel_fab.dataPtr(),NC_zvel_fab[lev][idx].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(host_NC_rho_fab.dataPtr(),NC_rho_fab[lev][idx].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(host_NC_rhotheta_fab.dataPtr(),NC_rhotheta_fab[lev][idx].box().numPts(),ioproc);
-#ifdef ERF_USE_TERRAIN
-        ParallelDescriptor::Bcast(host_NC_PHB_fab.dataPtr(),NC_PHB_fab[lev][idx].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(host_NC_PH_fab.dataPtr() ,NC_PH_fab[lev][idx].box().numPts() ,ioproc);
-#endif
+            AMREX_ALWAYS_ASSERT(bx == read_boxes[irhotheta][n]);
 
-#ifdef AMREX_USE_GPU
-         Gpu::copy(Gpu::hostToDevice, host_NC_xvel_fab.dataPtr(), host_NC_xvel_fab.dataPtr()+host_NC_xvel_fab.size(),
-                                           NC_xvel_fab[lev][idx].dataPtr());
-         Gpu::copy(Gpu::hostToDevice, host_NC_yvel_fab.dataPtr(), host_NC_yvel_fab.dataPtr()+host_NC_yvel_fab.size(),
-                                           NC_yvel_fab[lev][idx].dataPtr());
-         Gpu::copy(Gpu::hostToDevice, host_NC_zvel_fab.dataPtr(), host_NC_zvel_fab.dataPtr()+host_NC_zvel_fab.size(),
-                                           NC_zvel_fab[lev][idx].dataPtr());
-         Gpu::copy(Gpu::hostToDevice, host_NC_rho_fab.dataPtr(), host_NC_rho_fab.dataPtr()+host_NC_rho_fab.size(),
-                                           NC_rho_fab[lev][idx].dataPtr());
-         Gpu::copy(Gpu::hostToDevice, host_NC_rhotheta_fab.dataPtr(), host_NC_rhotheta_fab.dataPtr()+host_NC_rhotheta_fab.size(),
-                                           NC_rhotheta_fab[lev][idx].dataPtr());
-#ifdef ERF_USE_TERRAIN
-         Gpu::copy(Gpu::hostToDevice, host_NC_PH_fab.dataPtr(), host_NC_PH_fab.dataPtr()+host_NC_PH_fab.size(),
-                                           NC_PH_fab[lev][idx].dataPtr());
-         Gpu::copy(Gpu::hostToDevice, host_NC_PHB_fab.dataPtr(), host_NC_PHB_fab.dataPtr()+host_NC_PHB_fab.size(),
-                                           NC_PHB_fab[lev][idx].dataPtr()); #endif
-#endif
-#endif
+            const Array4<Real>      rho_arr = NC_fabs[irho][n]->array();
+            const Array4<Real> rhotheta_arr = NC_fabs[irhotheta][n]->array();
 
-        // Convert to rho by inverting
-        NC_rho_fab[lev][idx].template invert<RunOn::Device>(1.0);
+            // The ideal.exe NetCDF file has this ref value subtracted from theta or T_INIT. Need to add in ERF.
+            const Real theta_ref = 300.0;
 
-        // The ideal.exe NetCDF file has this ref value subtracted from theta or T_INIT. Need to add in ERF.
-        const Real theta_ref = 300.0;
-        NC_rhotheta_fab[lev][idx].template plus<RunOn::Device>(theta_ref);
+            ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                // Convert to rho by inverting
+                rho_arr(i,j,k) = 1.0 / rho_arr(i,j,k);
 
-        // Now multiply by rho to get (rho theta) instead of theta
-        NC_rhotheta_fab[lev][idx].template mult<RunOn::Device>(NC_rho_fab[lev][idx],0,0,1);
+                // Now multiply by rho to get (rho theta) instead of theta
+                rhotheta_arr(i,j,k) = (rhotheta_arr(i,j,k) + theta_ref) * rho_arr(i,j,k);
+            });
+        }
 
         amrex::Print() <<
           "Successfully loaded data from the wrfinput (output of 'ideal.exe' / 'real.exe') NetCDF file at level " << lev << std::endl;
     } // idx
 }
+
+void
+ERF::clear_wrfinput_data(int lev)
+{
+    NC_xvel_mf[lev].clear();
+    NC_yvel_mf[lev].clear();
+    NC_zvel_mf[lev].clear();
+    NC_rho_mf[lev].clear();
+    NC_rhotheta_mf[lev].clear();
+#ifdef ERF_USE_TERRAIN
+    NC_PH_mf[lev].clear();
+    NC_PHB_mf[lev].clear();
+#endif
+}
 #endif
 
 #ifdef ERF_USE_NETCDF
 void
 ERF::read_from_wrfbdy()
 {
-    // *********************************************************
-    // Allocate space for all of the boundary planes we may need
-    // Here we make only one enough space for one time -- we will
-    //    add space for the later time slices later
-    // *********************************************************
-
-    int ncomp = 4; // for right now just the velocities + temperature
-    const amrex::Box& domain = geom[0].Domain();
-    for (amrex::OrientationIter oit; oit != nullptr; ++oit) {
-        auto ori = oit();
-        if (ori.coordDir() < 2) {
-            const auto& lo = domain.loVect();
-            const auto& hi = domain.hiVect();
-
-            amrex::IntVect plo(lo);
-            amrex::IntVect phi(hi);
-            const int normal = ori.coordDir();
-            plo[normal] = ori.isHigh() ? hi[normal] + 1 : -1;
-            phi[normal] = ori.isHigh() ? hi[normal] + 1 : -1;
-            const amrex::Box pbx(plo, phi);
-            /*
-             TODO: Discuss
-             bdy_data_xlo contains 4 different variables U_BXS, V_BXS, W_BXS, T_BXS.
-             The dimensions of all these variables are not same as "pbx" or 1  X  NY    X  NZ
-             U_BXS -> dim -> 1  X  NY    X  NZ
-             V_BXS -> dim -> 1  X (NY+1) X  NZ
-             W_BXS -> dim -> 1  X  NY    X (NZ+1)
-             T_BXS -> dim -> 1  X  NY    X  NZ
-             */
-            /*
-             Instead of bdy_data_xlo with 4 components, should we use U_xlo, V_xlo, W_xlo, T_xLo separately?
-             */
-            if (ori.coordDir() == 0 && !ori.isHigh())
-                bdy_data_xlo.push_back(amrex::FArrayBox(pbx, ncomp));
-            if (ori.coordDir() == 0 && ori.isHigh())
-                bdy_data_xhi.push_back(amrex::FArrayBox(pbx, ncomp));
-            if (ori.coordDir() == 1 && !ori.isHigh())
-                bdy_data_ylo.push_back(amrex::FArrayBox(pbx, ncomp));
-            if (ori.coordDir() == 1 && ori.isHigh())
-                bdy_data_yhi.push_back(amrex::FArrayBox(pbx, ncomp));
-
-            /*
-             * Alternate data structure considering different dimensions of U, V, W, T on the planes
-            */
-            if (ori.coordDir() == 0) {
-                Box x_plane_no_stag(pbx);
-                Box x_plane_y_stag = convert(pbx, {0, 1, 0});
-                Box x_plane_z_stag = convert(pbx, {0, 0, 1});
-
-                Vector<FArrayBox> x_plane_data;
-                x_plane_data.push_back(FArrayBox(x_plane_no_stag, 1)); //U
-                x_plane_data.push_back(FArrayBox(x_plane_y_stag, 1)); //V
-                x_plane_data.push_back(FArrayBox(x_plane_z_stag, 1)); //W
-                x_plane_data.push_back(FArrayBox(x_plane_no_stag, 1)); // T
-
-//                if(!ori.isHigh())
-//                    bdy_x_lo.push_back(x_plane_data);
-//                if(ori.isHigh())
-//                    bdy_x_hi.push_back(x_plane_data);
-            }
-            if (ori.coordDir() == 1) {
-                Box y_plane_no_stag(pbx);
-                Box y_plane_x_stag = convert(pbx, {1, 0, 0});
-                Box y_plane_z_stag = convert(pbx, {0, 0, 1});
-
-                Vector<FArrayBox> y_plane_data;
-                y_plane_data.push_back(FArrayBox(y_plane_x_stag, 1)); //U
-                y_plane_data.push_back(FArrayBox(y_plane_no_stag, 1)); //V
-                y_plane_data.push_back(FArrayBox(y_plane_z_stag, 1)); //W
-                y_plane_data.push_back(FArrayBox(y_plane_no_stag, 1)); // T
-
-//                if(!ori.isHigh())
-//                    bdy_y_lo.push_back(y_plane_data);
-//                if(ori.isHigh())
-//                    bdy_y_hi.push_back(y_plane_data);
-            }
-        }
-    }
-
-    int ntimes;
-    if (ParallelDescriptor::IOProcessor())
-    {
-        // Read the netcdf file and fill these FABs
-        ntimes = BuildFABsFromWRFBdyFile(nc_bdy_file, bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi);
+    // Only the time levels bracketing the current time are held, and only on the ranks
+    //    owning level 0 grids next to the lateral boundaries
+    const MultiFab& S = vars_new[0][Vars::cons];
+    m_wrfbdy = std::make_unique<ReadWRFBdy>(nc_bdy_file, geom[0], S.boxArray(), S.DistributionMap(),
+                                            vars_new[0][Vars::xvel].nGrow());
 
-    } // if ParalleDescriptor::IOProcessor()
-
-    // We put a barrier here so the rest of the processors wait to do anything until they have the data
-    amrex::ParallelDescriptor::Barrier();
-
-    int ioproc = ParallelDescriptor::IOProcessorNumber();  // I/O rank
-
-    // Make sure all processors know how many times are stored
-    ParallelDescriptor::Bcast(&ntimes,1,ioproc);
-
-    // When an FArrayBox is built, space is allocated on every rank.  However, we only
-    //    filled the data in these FABs on the IOProcessor.  So here we broadcast
-    //    the data to every rank.
-    for (int nt = 0; nt < ntimes; nt++)
-    {
-        ParallelDescriptor::Bcast(bdy_data_xlo[nt].dataPtr(),bdy_data_xlo[nt].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(bdy_data_xhi[nt].dataPtr(),bdy_data_xhi[nt].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(bdy_data_ylo[nt].dataPtr(),bdy_data_ylo[nt].box().numPts(),ioproc);
-        ParallelDescriptor::Bcast(bdy_data_yhi[nt].dataPtr(),bdy_data_yhi[nt].box().numPts(),ioproc);
-    }
+    amrex::Real dt_dummy = 0.0;
+    m_wrfbdy->read_input_files(t_new[0], dt_dummy);
 
-    amrex::Print() << "Successfully loaded data from the wrfbdy (output of 'real.exe') NetCDF file" << std::endl << std::endl;
+    amrex::Print() << "Successfully set up reading from the wrfbdy (output of 'real.exe') NetCDF file" << std::endl << std::endl;
 }
 #endif // ERF_USE_NETCDF
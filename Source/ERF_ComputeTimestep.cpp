@@ -9,12 +9,19 @@ ERF::ComputeDt ()
 {
     Vector<Real> dt_tmp(finest_level+1);
 
+    // The inverse fast and slow time steps of all levels are reduced in a single message
+    Vector<Real> dt_inv(2*(finest_level+1));
     for (int lev = 0; lev <= finest_level; ++lev)
     {
-        dt_tmp[lev] = estTimeStep(lev, dt_mri_ratio[lev]);
+        estTimeStepInv(lev, dt_inv[2*lev], dt_inv[2*lev+1]);
     }
 
-    ParallelDescriptor::ReduceRealMin(&dt_tmp[0], dt_tmp.size());
+    ParallelDescriptor::ReduceRealMax(dt_inv.dataPtr(), dt_inv.size());
+
+    for (int lev = 0; lev <= finest_level; ++lev)
+    {
+        dt_tmp[lev] = estTimeStep(lev, dt_inv[2*lev], dt_inv[2*lev+1], dt_mri_ratio[lev]);
+    }
 
     Real dt_0 = dt_tmp[0];
     int n_factor = 1;
@@ -36,66 +43,62 @@ ERF::ComputeDt ()
     }
 }
 
-Real
-ERF::estTimeStep(int level, long& dt_fast_ratio) const
+void
+ERF::estTimeStepInv(int level, Real& estdt_comp_inv, Real& estdt_lowM_inv) const
 {
-  BL_PROFILE("ERF::estTimeStep()");
-
-  amrex::Real estdt_comp = 1.e20;
-  amrex::Real estdt_lowM = 1.e20;
+  BL_PROFILE("ERF::estTimeStepInv()");
 
   auto const dxinv = geom[level].InvCellSizeArray();
 
   MultiFab const& S_new = vars_new[level][Vars::cons];
+  MultiFab const& U_new = vars_new[level][Vars::xvel];
+  MultiFab const& V_new = vars_new[level][Vars::yvel];
+  MultiFab const& W_new = vars_new[level][Vars::zvel];
+
+  // Both bounds come from one pass that averages the face velocities to cell centers on the fly
+  ReduceOps<ReduceOpMax, ReduceOpMax> reduce_op;
+  ReduceData<Real, Real> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+  for (MFIter mfi(S_new, TilingIfNotGPU()); mfi.isValid(); ++mfi)
+  {
+      const Box& bx = mfi.tilebox();
+      const auto s = S_new.const_array(mfi);
+      const auto u = U_new.const_array(mfi);
+      const auto v = V_new.const_array(mfi);
+      const auto w = W_new.const_array(mfi);
+
+      reduce_op.eval(bx, reduce_data,
+      [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+      {
+          const amrex::Real rho      = s(i, j, k, Rho_comp);
+          const amrex::Real rhotheta = s(i, j, k, RhoTheta_comp);
+
+          amrex::Real pressure = getPgivenRTh(rhotheta);
+          amrex::Real c = std::sqrt(Gamma * pressure / rho);
+
+          const amrex::Real ux = amrex::Math::abs(0.5 * (u(i,j,k) + u(i+1,j,k))) * dxinv[0];
+          const amrex::Real uy = amrex::Math::abs(0.5 * (v(i,j,k) + v(i,j+1,k))) * dxinv[1];
+          const amrex::Real uz = amrex::Math::abs(0.5 * (w(i,j,k) + w(i,j,k+1))) * dxinv[2];
+
+          return {amrex::max(ux + c*dxinv[0], uy + c*dxinv[1], uz + c*dxinv[2]),
+                  amrex::max(ux, uy, uz)};
+      });
+  }
+
+  ReduceTuple hv = reduce_data.value();
+  estdt_comp_inv = amrex::get<0>(hv);
+  estdt_lowM_inv = amrex::get<1>(hv);
+}
+
+Real
+ERF::estTimeStep(int level, Real estdt_comp_inv, Real estdt_lowM_inv, long& dt_fast_ratio) const
+{
+  amrex::Real estdt_comp = cfl / estdt_comp_inv;
+  amrex::Real estdt_lowM = 1.e20;
 
-  MultiFab ccvel(grids[level],dmap[level],3,0);
-
-  average_face_to_cellcenter(ccvel,0,
-      Array<const MultiFab*,3>{&vars_new[level][Vars::xvel],
-                               &vars_new[level][Vars::yvel],
-                               &vars_new[level][Vars::zvel]});
-
-  Real estdt_comp_inv = amrex::ReduceMax(S_new, ccvel, 0,
-       [=] AMREX_GPU_HOST_DEVICE (Box const& b,
-                                  Array4<Real const> const& s,
-                                  Array4<Real const> const& u) -> Real
-       {
-           Real new_comp_dt = -1.e100;
-           amrex::Loop(b, [=,&new_comp_dt] (int i, int j, int k) noexcept
-           {
-               const amrex::Real rho      = s(i, j, k, Rho_comp);
-               const amrex::Real rhotheta = s(i, j, k, RhoTheta_comp);
-
-               amrex::Real pressure = getPgivenRTh(rhotheta);
-               amrex::Real c = std::sqrt(Gamma * pressure / rho);
-
-               new_comp_dt = amrex::max(((amrex::Math::abs(u(i,j,k,0))+c)*dxinv[0]),
-                                        ((amrex::Math::abs(u(i,j,k,1))+c)*dxinv[1]),
-                                        ((amrex::Math::abs(u(i,j,k,2))+c)*dxinv[2]), new_comp_dt);
-           });
-           return new_comp_dt;
-       });
-
-   amrex::ParallelDescriptor::ReduceRealMax(estdt_comp_inv);
-   estdt_comp = cfl / estdt_comp_inv;;
-
-   Real estdt_lowM_inv = amrex::ReduceMax(ccvel, 0,
-       [=] AMREX_GPU_HOST_DEVICE (Box const& b,
-                                  Array4<Real const> const& u) -> Real
-       {
-           Real new_lm_dt = -1.e100;
-           amrex::Loop(b, [=,&new_lm_dt] (int i, int j, int k) noexcept
-           {
-               new_lm_dt = amrex::max(((amrex::Math::abs(u(i,j,k,0)))*dxinv[0]),
-                                      ((amrex::Math::abs(u(i,j,k,1)))*dxinv[1]),
-                                      ((amrex::Math::abs(u(i,j,k,2)))*dxinv[2]), new_lm_dt);
-           });
-           return new_lm_dt;
-       });
-
-   amrex::ParallelDescriptor::ReduceRealMax(estdt_lowM_inv);
-   if (estdt_lowM_inv > 0.0_rt)
-       estdt_lowM = cfl / estdt_lowM_inv;;
+  if (estdt_lowM_inv > 0.0_rt)
+      estdt_lowM = cfl / estdt_lowM_inv;
 
   if (verbose) {
     if (fixed_dt <= 0.0) {
@@ -112,9 +112,6 @@ ERF::FillPatch (int lev, Real time, Vector<MultiFab>& mfs)
                                   m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                   z_phys_nd[lev], detJ_cc[lev],
-#endif
-#ifdef ERF_USE_NETCDF
-                                  bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                   m_r2d);
             amrex::FillPatchSingleLevel(mf, time, smf, ftime, 0, icomp, ncomp,
@@ -131,18 +128,12 @@ ERF::FillPatch (int lev, Real time, Vector<MultiFab>& mfs)
                                    m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                    z_phys_nd[lev-1],detJ_cc[lev-1],
-#endif
-#ifdef ERF_USE_NETCDF
-                                   bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                    m_r2d);
             ERFPhysBCFunct fphysbc(lev,geom[lev],domain_bcs_type,domain_bcs_type_d,var_idx,fdata,
                                    m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                    z_phys_nd[lev],detJ_cc[lev],
-#endif
-#ifdef ERF_USE_NETCDF
-                                   bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                    m_r2d);
 
@@ -167,7 +158,9 @@ ERF::FillPatch (int lev, Real time, Vector<MultiFab>& mfs)
         bool vert_only = true;
         ComputeTurbulentViscosity(fdata.get_var(Vars::xvel), fdata.get_var(Vars::yvel),
                                   fdata.get_var(Vars::zvel), fdata.get_var(Vars::cons),
-                                  eddyDiffs, geom[lev], solverChoice, m_most, domain_bcs_type_d, vert_only);
+                                  eddyDiffs, geom[lev], solverChoice, m_most,
+                                  get_mynn_columns(lev, eddyDiffs.boxArray(), eddyDiffs.DistributionMap()),
+                                  domain_bcs_type_d, vert_only);
         eddyDiffs.FillBoundary(geom[lev].periodicity());
 
         for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx)
@@ -255,9 +248,6 @@ ERF::FillIntermediatePatch (int lev, Real time, Vector<std::reference_wrapper<Mu
                                   m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                   z_phys_nd[lev],detJ_cc[lev],
-#endif
-#ifdef ERF_USE_NETCDF
-                                   bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                    m_r2d);
 
@@ -278,18 +268,12 @@ ERF::FillIntermediatePatch (int lev, Real time, Vector<std::reference_wrapper<Mu
                                   m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                    z_phys_nd[lev-1],detJ_cc[lev-1],
-#endif
-#ifdef ERF_USE_NETCDF
-                                   bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                    m_r2d);
             ERFPhysBCFunct fphysbc(lev,geom[lev],domain_bcs_type,domain_bcs_type_d,var_idx,level_data,
                                   m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                                    z_phys_nd[lev],detJ_cc[lev],
-#endif
-#ifdef ERF_USE_NETCDF
-                                   bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                                    m_r2d);
 
@@ -309,14 +293,21 @@ ERF::FillIntermediatePatch (int lev, Real time, Vector<std::reference_wrapper<Mu
     //
     if (!rho_only && m_most)
     {
-        MultiFab eddyDiffs(mfs[Vars::cons].get().boxArray(),
-                           mfs[Vars::cons].get().DistributionMap(),
-                           EddyDiff::NumDiffs,3);
+        // MOST needs the eddy viscosity of the bottom layer before its ghost values are imposed,
+        //     while erf_slow_rhs needs that of the state with them, so we only borrow the storage
+        //     of the stage closure here and leave it to be recomputed by erf_slow_rhs
+        MultiFab* eddyDiffs_ptr = get_eddy_diffs_storage(lev);
+        AMREX_ALWAYS_ASSERT_WITH_MESSAGE(eddyDiffs_ptr != nullptr,
+                                         "Must use an LES or PBL model to compute turbulent viscosity for MOST boundaries");
+        MultiFab& eddyDiffs = *eddyDiffs_ptr;
         bool vert_only = true;
         ComputeTurbulentViscosity(mfs[Vars::xvel].get(), mfs[Vars::yvel].get(),
                                   mfs[Vars::zvel].get(), mfs[Vars::cons].get(),
-                                  eddyDiffs, geom[lev], solverChoice, m_most, domain_bcs_type_d, vert_only);
+                                  eddyDiffs, geom[lev], solverChoice, m_most,
+                                  get_mynn_columns(lev, eddyDiffs.boxArray(), eddyDiffs.DistributionMap()),
+                                  domain_bcs_type_d, vert_only);
         eddyDiffs.FillBoundary(geom[lev].periodicity());
+        eddyDiffs_valid[lev] = 0;
 
         for (int var_idx = 0; var_idx < Vars::NumTypes; ++var_idx)
         {
@@ -383,18 +374,12 @@ ERF::FillCoarsePatch (int lev, Real time, MultiFab& mf, int icomp, int ncomp, in
                            m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                            z_phys_nd[lev-1],detJ_cc[lev-1],
-#endif
-#ifdef ERF_USE_NETCDF
-                           bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                            m_r2d);
     ERFPhysBCFunct fphysbc(lev,geom[lev],domain_bcs_type,domain_bcs_type_d,var_idx,fdata,
                            m_bc_extdir_vals,
 #ifdef ERF_USE_TERRAIN
                            z_phys_nd[lev],detJ_cc[lev],
-#endif
-#ifdef ERF_USE_NETCDF
-                           bdy_data_xlo, bdy_data_xhi, bdy_data_ylo, bdy_data_yhi,
 #endif
                            m_r2d);
 
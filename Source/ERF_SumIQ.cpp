@@ -12,34 +12,32 @@ ERF::sum_integrated_quantities(Real time)
     if (verbose <= 0)
       return;
 
-    int datwidth = 14;
-    int datprecision = 6;
+    const int datwidth = 14;
+    const int datprecision = 6;
 
     amrex::Real scalar = 0.0;
     amrex::Real mass   = 0.0;
 
+    // One pass over the data per level for all the sums
+    const amrex::Vector<int> comps = {Rho_comp, RhoScalar_comp};
     for (int lev = 0; lev <= finest_level; lev++) {
-        mass   += volWgtSumMF(lev,vars_new[lev][Vars::cons],Rho_comp,true,true);
-        scalar += volWgtSumMF(lev,vars_new[lev][Vars::cons],RhoScalar_comp,true,true);
+        const amrex::Vector<amrex::Real> sums = volWgtSumMF(lev,vars_new[lev][Vars::cons],comps,true,true);
+        mass   += sums[0];
+        scalar += sums[1];
     }
 
-    if (verbose > 0) {
-        const int nfoo = 2;
-        amrex::Real foo[nfoo] = {mass,scalar};
-#ifdef AMREX_LAZY
-        Lazy::QueueReduction([=]() mutable {
-#endif
-        amrex::ParallelDescriptor::ReduceRealSum(
-            foo, nfoo, amrex::ParallelDescriptor::IOProcessorNumber());
-
-          if (amrex::ParallelDescriptor::IOProcessor()) {
+    // The sums are reduced onto the IO rank in the background and printed once
+    //     they arrive, at the latest when the next sums are started
+    m_sum_reduce.start({mass, scalar},
+        [=] (const amrex::Vector<amrex::Real>& foo)
+        {
             int i = 0;
-            mass   = foo[i++];
-            scalar = foo[i++];
+            const amrex::Real mass_tot   = foo[i++];
+            const amrex::Real scalar_tot = foo[i++];
 
             amrex::Print() << '\n';
-            amrex::Print() << "TIME= " << time << " MASS        = " << mass   << '\n';
-            amrex::Print() << "TIME= " << time << " SCALAR      = " << scalar << '\n';
+            amrex::Print() << "TIME= " << time << " MASS        = " << mass_tot   << '\n';
+            amrex::Print() << "TIME= " << time << " SCALAR      = " << scalar_tot << '\n';
 
             if (NumDataLogs() > 0) {
                 std::ostream& data_log1 = DataLog(0);
@@ -54,17 +52,13 @@ ERF::sum_integrated_quantities(Real time)
                   // Write the quantities at this time
                   data_log1 << std::setw(datwidth) << time;
                   data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                            << mass;
+                            << mass_tot;
                   data_log1 << std::setw(datwidth) << std::setprecision(datprecision)
-                            << scalar;
+                            << scalar_tot;
                   data_log1 << std::endl;
               }
             }
-          }
-#ifdef AMREX_LAZY
         });
-#endif
-    }
 }
 
 amrex::Real
@@ -73,28 +67,108 @@ ERF::volWgtSumMF(int lev,
 {
     BL_PROFILE("ERF::volWgtSumMF()");
 
-    amrex::Real sum = 0.0;
-    amrex::MultiFab tmp(grids[lev], dmap[lev], 1, 0);
-    amrex::MultiFab::Copy(tmp, mf, comp, 0, 1, 0);
+    const amrex::MultiFab& volume = get_vol_wgt(lev, finemask);
 
-    if (lev < finest_level && finemask) {
-        const amrex::MultiFab& mask = build_fine_mask(lev+1);
-        amrex::MultiFab::Multiply(tmp, mask, 0, 0, 1, 0);
+    amrex::Real sum = amrex::MultiFab::Dot(mf, comp, volume, 0, 1, 0, local);
+
+    if (!local)
+      amrex::ParallelDescriptor::ReduceRealSum(sum);
+
+    return sum;
+}
+
+amrex::Vector<amrex::Real>
+ERF::volWgtSumMF(int lev,
+  const amrex::MultiFab& mf, const amrex::Vector<int>& comps, bool local, bool finemask)
+{
+    BL_PROFILE("ERF::volWgtSumMF(comps)");
+
+    constexpr int max_comps = 4;
+    const int ncomp = comps.size();
+    AMREX_ALWAYS_ASSERT(ncomp > 0 && ncomp <= max_comps);
+
+    // Unused slots point at the first component and are weighted by zero
+    amrex::GpuArray<int,max_comps> c;
+    amrex::GpuArray<amrex::Real,max_comps> on;
+    for (int n = 0; n < max_comps; ++n) {
+        c[n]  = (n < ncomp) ? comps[n] : comps[0];
+        on[n] = (n < ncomp) ? 1.0 : 0.0;
+    }
+
+    const amrex::MultiFab& volume = get_vol_wgt(lev, finemask);
+
+    amrex::ReduceOps<amrex::ReduceOpSum, amrex::ReduceOpSum,
+                     amrex::ReduceOpSum, amrex::ReduceOpSum> reduce_op;
+    amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+
+    for (amrex::MFIter mfi(mf, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const amrex::Box& bx = mfi.tilebox();
+        const auto  s_arr = mf.const_array(mfi);
+        const auto& v_arr = volume.const_array(mfi);
+        reduce_op.eval(bx, reduce_data,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept -> ReduceTuple
+        {
+            const amrex::Real w = v_arr(i,j,k);
+            return {on[0] * w * s_arr(i,j,k,c[0]), on[1] * w * s_arr(i,j,k,c[1]),
+                    on[2] * w * s_arr(i,j,k,c[2]), on[3] * w * s_arr(i,j,k,c[3])};
+        });
     }
 
-    amrex::MultiFab volume(grids[lev], dmap[lev], 1, 0);
-    auto const& dx = geom[lev].CellSizeArray();
-    Real cell_vol = dx[0]*dx[1]*dx[2];
-    volume.setVal(cell_vol);
+    ReduceTuple hv = reduce_data.value();
+    amrex::Vector<amrex::Real> sums = {amrex::get<0>(hv), amrex::get<1>(hv),
+                                       amrex::get<2>(hv), amrex::get<3>(hv)};
+    sums.resize(ncomp);
+
+    if (!local)
+      amrex::ParallelDescriptor::ReduceRealSum(sums.data(), ncomp);
+
+    return sums;
+}
+
+const amrex::MultiFab&
+ERF::get_vol_wgt(int lev, bool finemask)
+{
+    if (vol_wgt.size() <= lev) {
+        vol_wgt.resize(max_level+1);
+        vol_wgt_masked.resize(max_level+1);
+        fine_masks.resize(max_level+1);
+    }
+
+    if (!vol_wgt[lev]) {
+        vol_wgt[lev] = std::make_unique<amrex::MultiFab>(grids[lev], dmap[lev], 1, 0);
+        auto const& dx = geom[lev].CellSizeArray();
+        Real cell_vol = dx[0]*dx[1]*dx[2];
+        vol_wgt[lev]->setVal(cell_vol);
 #ifdef ERF_USE_TERRAIN
-    amrex::MultiFab::Multiply(volume, detJ_cc[lev], 0, 0, 1, 0);
+        amrex::MultiFab::Multiply(*vol_wgt[lev], detJ_cc[lev], 0, 0, 1, 0);
 #endif
-    sum = amrex::MultiFab::Dot(tmp, 0, volume, 0, 1, 0, local);
+    }
 
-    if (!local)
-      amrex::ParallelDescriptor::ReduceRealSum(sum);
+    if (lev < finest_level && finemask) {
+        if (!vol_wgt_masked[lev]) {
+            vol_wgt_masked[lev] = std::make_unique<amrex::MultiFab>(grids[lev], dmap[lev], 1, 0);
+            amrex::MultiFab::Copy(*vol_wgt_masked[lev], *vol_wgt[lev], 0, 0, 1, 0);
+            amrex::MultiFab::Multiply(*vol_wgt_masked[lev], build_fine_mask(lev+1), 0, 0, 1, 0);
+        }
+        return *vol_wgt_masked[lev];
+    }
 
-    return sum;
+    return *vol_wgt[lev];
+}
+
+void
+ERF::clear_sum_weights(int lev)
+{
+    // The volume weights at lev, the masked weights at lev-1 and lev, and the
+    //     masks built from the grids at lev all depend on the grids at lev
+    for (int ilev = lev-1; ilev <= lev+1; ++ilev) {
+        if (ilev < 0 || ilev >= vol_wgt.size()) continue;
+        if (ilev <= lev) vol_wgt_masked[ilev].reset();
+        if (ilev >= lev) fine_masks[ilev].reset();
+    }
+    if (lev < vol_wgt.size()) vol_wgt[lev].reset();
 }
 
 amrex::MultiFab&
@@ -103,11 +177,14 @@ ERF::build_fine_mask(int level)
   // Mask for zeroing covered cells
   AMREX_ASSERT(level > 0);
 
+  if (fine_masks.size() <= level) fine_masks.resize(max_level+1);
+  if (fine_masks[level]) return *fine_masks[level];
+
   const amrex::BoxArray& cba = grids[level-1];
   const amrex::DistributionMapping& cdm = dmap[level-1];
 
-  // TODO -- we should make a vector of these a member of ERF class
-  fine_mask.define(cba, cdm, 1, 0, amrex::MFInfo());
+  fine_masks[level] = std::make_unique<amrex::MultiFab>(cba, cdm, 1, 0, amrex::MFInfo());
+  amrex::MultiFab& fine_mask = *fine_masks[level];
   fine_mask.setVal(1.0);
 
   amrex::BoxArray fba = grids[level];
@@ -95,22 +95,33 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
 
     FillPatch(lev, time, vars_old[lev]);
 
-    MultiFab* S_crse;
-    MultiFab rU_crse, rV_crse, rW_crse;
+    // The old state at this level has changed, so the next finer level must rebuild its coarse momenta
+    if (lev < max_level) crse_mom_valid[lev+1] = 0;
 
-    if (lev > 0)
+    MultiFab& rU_crse = crse_mom[lev][0];
+    MultiFab& rV_crse = crse_mom[lev][1];
+    MultiFab& rW_crse = crse_mom[lev][2];
+
+    // The old coarse state does not change while we subcycle, so we only do this once per coarse step
+    if (lev > 0 && !crse_mom_valid[lev])
     {
-        S_crse = &vars_old[lev-1][Vars::cons];
+        MultiFab* S_crse = &vars_old[lev-1][Vars::cons];
 
         MultiFab& U_crse = vars_old[lev-1][Vars::xvel];
         MultiFab& V_crse = vars_old[lev-1][Vars::yvel];
         MultiFab& W_crse = vars_old[lev-1][Vars::zvel];
 
-        rU_crse.define(U_crse.boxArray(), U_crse.DistributionMap(), 1, U_crse.nGrow());
-        rV_crse.define(V_crse.boxArray(), V_crse.DistributionMap(), 1, V_crse.nGrow());
-        rW_crse.define(W_crse.boxArray(), W_crse.DistributionMap(), 1, W_crse.nGrow());
+        if (!rU_crse.ok() || rU_crse.boxArray() != U_crse.boxArray() ||
+            rU_crse.DistributionMap() != U_crse.DistributionMap())
+        {
+            rU_crse.define(U_crse.boxArray(), U_crse.DistributionMap(), 1, U_crse.nGrow());
+            rV_crse.define(V_crse.boxArray(), V_crse.DistributionMap(), 1, V_crse.nGrow());
+            rW_crse.define(W_crse.boxArray(), W_crse.DistributionMap(), 1, W_crse.nGrow());
+        }
 
         VelocityToMomentum(U_crse,V_crse,W_crse,*S_crse,rU_crse,rV_crse,rW_crse,U_crse.nGrowVect());
+
+        crse_mom_valid[lev] = 1;
     }
 
     // configure ABLMost params if used MostWall boundary condition
@@ -124,12 +135,11 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
         amrex::Error("Must use MOST BC for MYNN2.5 PBL model");
     }
 
-    const auto& local_ref_ratio = (lev > 0) ? ref_ratio[lev-1] : IntVect(1,1,1);
-
-    InterpFaceRegister ifr;
-    if (lev > 0)
+    // The register only depends on the grids at this level, so we keep it until they change
+    if (lev > 0 && !interp_face_reg[lev])
     {
-        ifr.define(S_old.boxArray(), S_old.DistributionMap(), Geom(lev), local_ref_ratio);
+        interp_face_reg[lev] = std::make_unique<InterpFaceRegister>(S_old.boxArray(), S_old.DistributionMap(),
+                                                                    Geom(lev), ref_ratio[lev-1]);
     }
 
     const BoxArray&            ba = S_old.boxArray();
@@ -142,20 +152,9 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     source.setVal(0.0);
 
     // These are the actual fluxes we will use to fill the flux registers
+    //     (erf_advance swaps its time-integrated fluxes in here)
     std::array< MultiFab, AMREX_SPACEDIM > flux;
 
-    flux[0].define(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
-    flux[1].define(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
-    flux[2].define(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
-
-    flux[0].setVal(0.);
-    flux[1].setVal(0.);
-    flux[2].setVal(0.);
-
-    // We don't need to call FillPatch on cons_mf because we have fillpatch'ed S_old above
-    MultiFab cons_mf(ba,dm,nvars,S_old.nGrowVect());
-    MultiFab::Copy(cons_mf,S_old,0,0,S_old.nComp(),S_old.nGrowVect());
-
     // Pass the 1D arrays if relevant
 #ifdef ERF_USE_TERRAIN
     MultiFab& r0 = dens_hse[lev];
@@ -185,14 +184,16 @@ ERF::Advance (int lev, Real time, Real dt_lev, int /*iteration*/, int /*ncycle*/
     //          W_new    (z-velocity on z-faces)
     // *****************************************************************
 
+    // erf_advance copies S_old (which we have fillpatch'ed above) into its own state,
+    //     so we pass it directly rather than through another copy
     erf_advance(lev,
-                cons_mf, S_new,
+                S_old, S_new,
                 U_old, V_old, W_old,
                 U_new, V_new, W_new,
                 rU_crse, rV_crse, rW_crse,
                 source, flux,
                 Geom(lev), dt_lev, time,
-                &ifr,
+                interp_face_reg[lev].get(),
 #ifdef ERF_USE_TERRAIN
                 r0, p0,
 #else
@@ -0,0 +1,482 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include "AMReX_ParallelDescriptor.H"
+#include "AMReX_PlotFileUtil.H"
+#include "AMReX_Utility.H"
+#include "ERF_PlotCompress.H"
+
+using namespace amrex;
+
+namespace {
+
+    const std::string header_version = "ERF-CompressedPlotfile-V1";
+
+    enum EncodeMode : unsigned char {
+        raw = 0,
+        quantized
+    };
+
+    template <typename T>
+    void append (Vector<char>& buf, const T& val)
+    {
+        const char* p = reinterpret_cast<const char*>(&val);
+        buf.insert(buf.end(), p, p+sizeof(T));
+    }
+
+    template <typename T>
+    T extract (const char*& p)
+    {
+        T val;
+        std::memcpy(&val, p, sizeof(T));
+        p += sizeof(T);
+        return val;
+    }
+
+    void put_varint (Vector<char>& buf, std::uint64_t v)
+    {
+        while (v >= 0x80) {
+            buf.push_back(static_cast<char>((v & 0x7f) | 0x80));
+            v >>= 7;
+        }
+        buf.push_back(static_cast<char>(v));
+    }
+
+    std::uint64_t get_varint (const char*& p)
+    {
+        std::uint64_t v = 0;
+        int shift = 0;
+        unsigned char b;
+        do {
+            b = static_cast<unsigned char>(*p++);
+            v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        return v;
+    }
+
+    std::uint64_t zigzag (std::int64_t v)
+    {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    std::int64_t unzigzag (std::uint64_t v)
+    {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    // Zero bytes are stored as a 0 followed by the length of the run of zeros
+    void rle_encode (const Vector<char>& in, Vector<char>& out)
+    {
+        std::size_t n = 0;
+        while (n < in.size()) {
+            if (in[n] == 0) {
+                std::uint64_t run = 0;
+                while (n < in.size() && in[n] == 0) { ++run; ++n; }
+                out.push_back(0);
+                put_varint(out, run);
+            } else {
+                out.push_back(in[n++]);
+            }
+        }
+    }
+
+    void rle_decode (const char* p, std::size_t nbytes, Vector<char>& out)
+    {
+        const char* end = p + nbytes;
+        while (p < end) {
+            if (*p == 0) {
+                ++p;
+                std::uint64_t run = get_varint(p);
+                out.insert(out.end(), run, 0);
+            } else {
+                out.push_back(*p++);
+            }
+        }
+    }
+
+    std::string DataFileName (const std::string& dir, int lev, int rank)
+    {
+        return dir + "/" + LevelPath(lev, "Level_") + "/" + Concatenate("Cell_D_", rank, 5);
+    }
+
+} // namespace
+
+void
+PlotCompress::encode (const Real* data, Long npts, Real eb, Vector<char>& buf)
+{
+    buf.clear();
+
+    Real vmin = std::numeric_limits<Real>::max();
+    Real vmax = std::numeric_limits<Real>::lowest();
+    for (Long n = 0; n < npts; ++n) {
+        vmin = amrex::min(vmin, data[n]);
+        vmax = amrex::max(vmax, data[n]);
+    }
+
+    // A constant field is represented exactly by the quantized path with q = 0
+    double width = (vmax > vmin) ? 2.0 * static_cast<double>(eb) : 1.0;
+    bool quantize = (npts > 0) && (width > 0.0) &&
+                    (static_cast<double>(vmax - vmin) / width < 4.0e15);
+
+    Vector<char> bytes;
+    if (quantize) {
+        bytes.reserve(npts);
+        std::int64_t prev = 0;
+        for (Long n = 0; n < npts; ++n) {
+            const std::int64_t q = std::llround((data[n] - vmin) / width);
+            // Guard against roundoff when eb is tiny relative to the data
+            const Real recon = static_cast<Real>(vmin + q * width);
+            if (std::abs(recon - data[n]) > eb) {
+                quantize = false;
+                break;
+            }
+            put_varint(bytes, zigzag(q - prev));
+            prev = q;
+        }
+    }
+
+    if (!quantize) {
+        // Byte-shuffle so that the (often identical) high-order bytes are contiguous
+        constexpr std::size_t nb = sizeof(Real);
+        bytes.resize(npts*nb);
+        const char* rawp = reinterpret_cast<const char*>(data);
+        for (std::size_t b = 0; b < nb; ++b) {
+            for (Long n = 0; n < npts; ++n) {
+                bytes[b*npts+n] = rawp[n*nb+b];
+            }
+        }
+    }
+
+    Vector<char> payload;
+    payload.reserve(bytes.size());
+    rle_encode(bytes, payload);
+
+    append(buf, static_cast<unsigned char>(quantize ? EncodeMode::quantized : EncodeMode::raw));
+    append(buf, static_cast<double>(vmin));
+    append(buf, width);
+    append(buf, static_cast<std::uint64_t>(payload.size()));
+    buf.insert(buf.end(), payload.begin(), payload.end());
+}
+
+std::size_t
+PlotCompress::decode (const char* buf, Real* data, Long npts)
+{
+    const char* p = buf;
+    const auto mode        = extract<unsigned char>(p);
+    const auto vmin        = extract<double>(p);
+    const auto width       = extract<double>(p);
+    const auto payload_len = extract<std::uint64_t>(p);
+
+    Vector<char> bytes;
+    rle_decode(p, payload_len, bytes);
+    p += payload_len;
+
+    if (mode == EncodeMode::quantized) {
+        const char* q_ptr = bytes.data();
+        std::int64_t q = 0;
+        for (Long n = 0; n < npts; ++n) {
+            q += unzigzag(get_varint(q_ptr));
+            data[n] = static_cast<Real>(vmin + q * width);
+        }
+    } else {
+        constexpr std::size_t nb = sizeof(Real);
+        AMREX_ALWAYS_ASSERT(bytes.size() == npts*nb);
+        char* rawp = reinterpret_cast<char*>(data);
+        for (std::size_t b = 0; b < nb; ++b) {
+            for (Long n = 0; n < npts; ++n) {
+                rawp[n*nb+b] = bytes[b*npts+n];
+            }
+        }
+    }
+
+    return static_cast<std::size_t>(p - buf);
+}
+
+Vector<Real>
+PlotCompress::WriteCompressedPlotfile (const std::string& dir, int nlevels,
+                                       const Vector<const MultiFab*>& mf,
+                                       const Vector<std::string>& varnames,
+                                       const Vector<Tolerance>& tols,
+                                       const Vector<Geometry>& geom,
+                                       Real time,
+                                       const Vector<int>& level_steps,
+                                       const Vector<IntVect>& ref_ratio)
+{
+    BL_PROFILE("PlotCompress::WriteCompressedPlotfile()");
+
+    const int ncomp = mf[0]->nComp();
+    AMREX_ALWAYS_ASSERT(varnames.size() == ncomp);
+    AMREX_ALWAYS_ASSERT(tols.size() == ncomp);
+
+    // Relative tolerances are with respect to the value range over all levels
+    Vector<Real> vmin(ncomp, std::numeric_limits<Real>::max());
+    Vector<Real> vmax(ncomp, std::numeric_limits<Real>::lowest());
+    for (int lev = 0; lev < nlevels; ++lev) {
+        for (int n = 0; n < ncomp; ++n) {
+            vmin[n] = amrex::min(vmin[n], mf[lev]->min(n,0,true));
+            vmax[n] = amrex::max(vmax[n], mf[lev]->max(n,0,true));
+        }
+    }
+    ParallelDescriptor::ReduceRealMin(vmin.dataPtr(), ncomp);
+    ParallelDescriptor::ReduceRealMax(vmax.dataPtr(), ncomp);
+
+    Vector<Real> eb(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        eb[n] = tols[n].relative ? tols[n].tol * (vmax[n] - vmin[n]) : tols[n].tol;
+    }
+
+    PreBuildDirectorHierarchy(dir, "Level_", nlevels, true);
+
+    const int myproc = ParallelDescriptor::MyProc();
+
+    // For each box we hold (offset, nbytes) in its data file
+    Vector<Vector<Long>> box_loc(nlevels);
+
+    for (int lev = 0; lev < nlevels; ++lev)
+    {
+        const BoxArray& ba = mf[lev]->boxArray();
+        box_loc[lev].resize(2*ba.size(), 0);
+
+        if (mf[lev]->local_size() > 0)
+        {
+            std::ofstream ofs(DataFileName(dir, lev, myproc),
+                              std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+            if (!ofs.good()) FileOpenFailed(DataFileName(dir, lev, myproc));
+
+            Vector<char> buf;
+            for (MFIter mfi(*mf[lev]); mfi.isValid(); ++mfi)
+            {
+                const Box& bx = mfi.validbox();
+                const Long npts = bx.numPts();
+
+                FArrayBox host_fab(bx, ncomp, The_Pinned_Arena());
+                host_fab.template copy<RunOn::Device>((*mf[lev])[mfi], bx, 0, bx, 0, ncomp);
+                Gpu::streamSynchronize();
+
+                const Long start = static_cast<Long>(ofs.tellp());
+                for (int n = 0; n < ncomp; ++n) {
+                    encode(host_fab.dataPtr(n), npts, eb[n], buf);
+                    ofs.write(buf.data(), buf.size());
+                }
+                box_loc[lev][2*mfi.index()  ] = start;
+                box_loc[lev][2*mfi.index()+1] = static_cast<Long>(ofs.tellp()) - start;
+            }
+        }
+
+        // Each box is written by exactly one rank so a sum gathers all locations
+        ParallelDescriptor::ReduceLongSum(box_loc[lev].dataPtr(), box_loc[lev].size(),
+                                          ParallelDescriptor::IOProcessorNumber());
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::string HeaderFileName(dir + "/Header");
+        std::ofstream HeaderFile(HeaderFileName.c_str(), std::ofstream::out   |
+                                                         std::ofstream::trunc |
+                                                         std::ofstream::binary);
+        if (!HeaderFile.good()) FileOpenFailed(HeaderFileName);
+
+        HeaderFile.precision(17);
+
+        HeaderFile << header_version << '\n';
+        HeaderFile << ncomp << '\n';
+        for (int n = 0; n < ncomp; ++n) {
+            HeaderFile << varnames[n] << ' ' << eb[n] << '\n';
+        }
+        HeaderFile << time << '\n';
+        HeaderFile << nlevels-1 << '\n';
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) HeaderFile << geom[0].ProbLo(i) << ' ';
+        HeaderFile << '\n';
+        for (int i = 0; i < AMREX_SPACEDIM; ++i) HeaderFile << geom[0].ProbHi(i) << ' ';
+        HeaderFile << '\n';
+        for (int lev = 0; lev < nlevels-1; ++lev) HeaderFile << ref_ratio[lev] << ' ';
+        HeaderFile << '\n';
+
+        for (int lev = 0; lev < nlevels; ++lev)
+        {
+            const BoxArray& ba = mf[lev]->boxArray();
+            const DistributionMapping& dm = mf[lev]->DistributionMap();
+            HeaderFile << geom[lev].Domain() << ' ' << level_steps[lev] << ' ' << ba.size() << '\n';
+            for (int i = 0; i < ba.size(); ++i) {
+                HeaderFile << ba[i] << ' ' << dm[i] << ' '
+                           << box_loc[lev][2*i] << ' ' << box_loc[lev][2*i+1] << '\n';
+            }
+        }
+    }
+
+    return eb;
+}
+
+void
+PlotCompress::Header::read (const std::string& dir)
+{
+    std::string HeaderFileName(dir + "/Header");
+    std::ifstream is(HeaderFileName.c_str());
+    if (!is.good()) FileOpenFailed(HeaderFileName);
+
+    std::string version;
+    is >> version;
+    if (version != header_version) {
+        Abort("PlotCompress: " + HeaderFileName + " is not a compressed ERF plotfile");
+    }
+
+    int ncomp;
+    is >> ncomp;
+    varnames.resize(ncomp);
+    abs_tol.resize(ncomp);
+    for (int n = 0; n < ncomp; ++n) {
+        is >> varnames[n] >> abs_tol[n];
+    }
+
+    is >> time >> finest_level;
+
+    Real lo[AMREX_SPACEDIM], hi[AMREX_SPACEDIM];
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) is >> lo[i];
+    for (int i = 0; i < AMREX_SPACEDIM; ++i) is >> hi[i];
+    prob_domain = RealBox(lo, hi);
+
+    const int nlevels = finest_level+1;
+    ref_ratio.resize(finest_level);
+    for (int lev = 0; lev < finest_level; ++lev) is >> ref_ratio[lev];
+
+    domain.resize(nlevels);
+    level_steps.resize(nlevels);
+    grids.resize(nlevels);
+    rank.resize(nlevels);
+    offset.resize(nlevels);
+    nbytes.resize(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev)
+    {
+        int nboxes;
+        is >> domain[lev] >> level_steps[lev] >> nboxes;
+
+        BoxList bl;
+        rank[lev].resize(nboxes);
+        offset[lev].resize(nboxes);
+        nbytes[lev].resize(nboxes);
+        for (int i = 0; i < nboxes; ++i) {
+            Box bx;
+            is >> bx >> rank[lev][i] >> offset[lev][i] >> nbytes[lev][i];
+            bl.push_back(bx);
+        }
+        grids[lev] = BoxArray(bl);
+    }
+}
+
+void
+PlotCompress::ReadCompressedFab (const std::string& dir, const Header& hdr,
+                                 int lev, int ibox, FArrayBox& fab)
+{
+    const Box& bx = hdr.grids[lev][ibox];
+    const int ncomp = hdr.varnames.size();
+    AMREX_ALWAYS_ASSERT(fab.box().contains(bx) && fab.nComp() >= ncomp);
+
+    const std::string fname = DataFileName(dir, lev, hdr.rank[lev][ibox]);
+    std::ifstream ifs(fname, std::ifstream::in | std::ifstream::binary);
+    if (!ifs.good()) FileOpenFailed(fname);
+
+    Vector<char> buf(hdr.nbytes[lev][ibox]);
+    ifs.seekg(hdr.offset[lev][ibox]);
+    ifs.read(buf.data(), buf.size());
+
+    FArrayBox host_fab(bx, ncomp, The_Pinned_Arena());
+    const char* p = buf.data();
+    for (int n = 0; n < ncomp; ++n) {
+        p += decode(p, host_fab.dataPtr(n), bx.numPts());
+    }
+
+    fab.template copy<RunOn::Device>(host_fab, bx, 0, bx, 0, ncomp);
+    Gpu::streamSynchronize();
+}
+
+void
+PlotCompress::ReadCompressedPlotfile (const std::string& dir, Header& hdr,
+                                      Vector<MultiFab>& mf)
+{
+    BL_PROFILE("PlotCompress::ReadCompressedPlotfile()");
+
+    hdr.read(dir);
+
+    const int nlevels = hdr.finest_level+1;
+    const int ncomp = hdr.varnames.size();
+
+    mf.resize(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev)
+    {
+        DistributionMapping dm(hdr.grids[lev]);
+        mf[lev].define(hdr.grids[lev], dm, ncomp, 0);
+        for (MFIter mfi(mf[lev]); mfi.isValid(); ++mfi) {
+            ReadCompressedFab(dir, hdr, lev, mfi.index(), mf[lev][mfi]);
+        }
+    }
+}
+
+void
+PlotCompress::ConvertCompressedPlotfile (const std::string& in_dir, const std::string& out_dir)
+{
+    Header hdr;
+    Vector<MultiFab> mf;
+    ReadCompressedPlotfile(in_dir, hdr, mf);
+
+    const int nlevels = hdr.finest_level+1;
+    Vector<Geometry> geom(nlevels);
+    for (int lev = 0; lev < nlevels; ++lev) {
+        geom[lev].define(hdr.domain[lev], &hdr.prob_domain, CoordSys::cartesian);
+    }
+
+    WriteMultiLevelPlotfile(out_dir, nlevels, GetVecOfConstPtrs(mf), hdr.varnames,
+                            geom, hdr.time, hdr.level_steps, hdr.ref_ratio);
+}
+
+void
+PlotCompress::VerifyCompressedPlotfile (const std::string& dir, int nlevels,
+                                        const Vector<const MultiFab*>& mf)
+{
+    BL_PROFILE("PlotCompress::VerifyCompressedPlotfile()");
+
+    // Make sure all ranks have finished writing before we read anything back
+    ParallelDescriptor::Barrier();
+
+    Header hdr;
+    hdr.read(dir);
+
+    const int ncomp = hdr.varnames.size();
+    Vector<Real> max_err(ncomp, 0.0);
+
+    for (int lev = 0; lev < nlevels; ++lev)
+    {
+        for (MFIter mfi(*mf[lev]); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            FArrayBox orig(bx, ncomp, The_Pinned_Arena());
+            FArrayBox dcmp(bx, ncomp, The_Pinned_Arena());
+            orig.template copy<RunOn::Device>((*mf[lev])[mfi], bx, 0, bx, 0, ncomp);
+            ReadCompressedFab(dir, hdr, lev, mfi.index(), dcmp);
+
+            const Long npts = bx.numPts();
+            for (int n = 0; n < ncomp; ++n) {
+                const Real* po = orig.dataPtr(n);
+                const Real* pd = dcmp.dataPtr(n);
+                for (Long i = 0; i < npts; ++i) {
+                    max_err[n] = amrex::max(max_err[n], std::abs(po[i] - pd[i]));
+                }
+            }
+        }
+    }
+
+    ParallelDescriptor::ReduceRealMax(max_err.dataPtr(), ncomp);
+
+    bool ok = true;
+    for (int n = 0; n < ncomp; ++n) {
+        amrex::Print() << "Compressed plotfile " << dir << " : " << hdr.varnames[n]
+                       << " max error " << max_err[n] << " (bound " << hdr.abs_tol[n] << ")" << std::endl;
+        if (max_err[n] > hdr.abs_tol[n]) ok = false;
+    }
+    if (!ok) {
+        Abort("PlotCompress: error bound violated in " + dir);
+    }
+}
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+#include "AMReX_Gpu.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Utility.H"
+#include "ERF_Probes.H"
+#include "IndexDefines.H"
+#include "EOS.H"
+
+using namespace amrex;
+
+namespace {
+
+    // Note: the order here must match the ProbeVar enum in ERF_Probes.H
+    const Vector<std::string> probe_var_names {"x_velocity", "y_velocity", "z_velocity",
+                                               "density", "theta", "temp", "pressure", "scalar"};
+
+    AMREX_GPU_HOST_DEVICE AMREX_FORCE_INLINE
+    Real cc_value (int var, const Array4<const Real>& s, int i, int j, int k)
+    {
+        switch (var) {
+            case Probes::density:  return s(i,j,k,Rho_comp);
+            case Probes::theta:    return s(i,j,k,RhoTheta_comp) / s(i,j,k,Rho_comp);
+            case Probes::temp:     return getTgivenRandRTh(s(i,j,k,Rho_comp), s(i,j,k,RhoTheta_comp));
+            case Probes::pressure: return getPgivenRTh(s(i,j,k,RhoTheta_comp));
+            default:               return s(i,j,k,RhoScalar_comp) / s(i,j,k,Rho_comp);
+        }
+    }
+
+} // namespace
+
+Probes::Probes (const Vector<Geometry>& geom): m_geom(geom)
+{
+    ParmParse pp("erf");
+
+    pp.query("probe_dir", m_dirname);
+    pp.query("probe_interval", m_interval);
+    pp.query("probe_per", m_per);
+    pp.query("probe_buffer_size", m_buffer_size);
+    if (m_interval <= 0 && m_per <= 0.0) {
+        Error("Probes: must specify erf.probe_interval or erf.probe_per");
+    }
+
+    m_var_names = {"x_velocity", "y_velocity", "z_velocity", "theta"};
+    if (pp.contains("probe_vars")) {
+        m_var_names.resize(pp.countval("probe_vars"));
+        pp.getarr("probe_vars", m_var_names, 0, m_var_names.size());
+    }
+    for (const auto& var : m_var_names) {
+        auto it = std::find(probe_var_names.begin(), probe_var_names.end(), var);
+        if (it == probe_var_names.end()) {
+            Error("Probes: don't know how to sample variable " + var);
+        }
+        m_vars.push_back(static_cast<int>(it - probe_var_names.begin()));
+    }
+
+    const Real* prob_lo = geom[0].ProbLo();
+    const Real* prob_hi = geom[0].ProbHi();
+
+    int num_probes = pp.countval("probe_names");
+    Vector<std::string> names(num_probes);
+    pp.queryarr("probe_names", names, 0, num_probes);
+    Vector<int> probe_start;
+
+    for (const auto& name : names)
+    {
+        ParmParse ppp("erf." + name);
+
+        std::string type;
+        ppp.get("type", type);
+
+        probe_start.push_back(m_x.size());
+
+        auto add_point = [&] (Real x, Real y, Real z)
+        {
+            if (x < prob_lo[0] || x > prob_hi[0] ||
+                y < prob_lo[1] || y > prob_hi[1] ||
+                z < prob_lo[2] || z > prob_hi[2]) {
+                Error("Probes: a point of probe " + name + " is outside the domain");
+            }
+            m_x.push_back(x);
+            m_y.push_back(y);
+            m_z.push_back(z);
+        };
+
+        if (type == "point") {
+            Vector<Real> loc(AMREX_SPACEDIM);
+            ppp.getarr("loc", loc, 0, AMREX_SPACEDIM);
+            add_point(loc[0], loc[1], loc[2]);
+
+        } else if (type == "line") {
+            Vector<Real> start(AMREX_SPACEDIM), end(AMREX_SPACEDIM);
+            int npts;
+            ppp.getarr("start", start, 0, AMREX_SPACEDIM);
+            ppp.getarr("end", end, 0, AMREX_SPACEDIM);
+            ppp.get("npts", npts);
+            for (int n = 0; n < npts; ++n) {
+                const Real f = (npts > 1) ? Real(n) / Real(npts-1) : 0.0;
+                add_point(start[0] + f*(end[0]-start[0]),
+                          start[1] + f*(end[1]-start[1]),
+                          start[2] + f*(end[2]-start[2]));
+            }
+
+        } else if (type == "tower") {
+            // By default sample at every level-0 cell center in the vertical
+            Vector<Real> loc(2);
+            ppp.getarr("loc", loc, 0, 2);
+            const Real dz = geom[0].CellSize(2);
+            Real z_lo = prob_lo[2] + 0.5*dz;
+            Real z_hi = prob_hi[2] - 0.5*dz;
+            int npts = geom[0].Domain().length(2);
+            ppp.query("z_lo", z_lo);
+            ppp.query("z_hi", z_hi);
+            ppp.query("npts", npts);
+            for (int n = 0; n < npts; ++n) {
+                const Real f = (npts > 1) ? Real(n) / Real(npts-1) : 0.0;
+                add_point(loc[0], loc[1], z_lo + f*(z_hi-z_lo));
+            }
+
+        } else if (type == "file") {
+            // One "x y z" triplet per line
+            std::string fname;
+            ppp.get("file", fname);
+            Vector<char> fileCharPtr;
+            ParallelDescriptor::ReadAndBcastFile(fname, fileCharPtr);
+            std::istringstream is(fileCharPtr.dataPtr(), std::istringstream::in);
+            Real x, y, z;
+            while (is >> x >> y >> z) {
+                add_point(x, y, z);
+            }
+
+        } else {
+            Error("Probes: probe type must be point, line, tower or file");
+        }
+    }
+    probe_start.push_back(m_x.size());
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if (!UtilCreateDirectory(m_dirname, 0755)) CreateDirectoryFailed(m_dirname);
+
+        // The header lists the variables and the points of each probe; each record in
+        //     the data file is t_step time followed by the values at every point
+        //     (all variables of the first point, then the second point, etc)
+        std::ofstream hdr(m_dirname + "/Header");
+        hdr.precision(17);
+        hdr << m_var_names.size();
+        for (const auto& v : m_var_names) hdr << ' ' << v;
+        hdr << '\n';
+        hdr << sizeof(Real) << '\n';
+        hdr << names.size() << '\n';
+        for (int n = 0; n < names.size(); ++n) {
+            hdr << names[n] << ' ' << probe_start[n+1]-probe_start[n] << '\n';
+            for (int ip = probe_start[n]; ip < probe_start[n+1]; ++ip) {
+                hdr << m_x[ip] << ' ' << m_y[ip] << ' ' << m_z[ip] << '\n';
+            }
+        }
+
+        // Append so that restarted runs continue the same time series
+        m_ofs = std::make_unique<std::ofstream>(m_dirname + "/data.bin",
+                                                std::ios::out | std::ios::app | std::ios::binary);
+        if (!m_ofs->good()) FileOpenFailed(m_dirname + "/data.bin");
+    }
+}
+
+Probes::~Probes ()
+{
+    flush();
+}
+
+void
+Probes::sample (int t_step, Real time,
+                const Vector<BoxArray>& grids,
+                Vector<Vector<MultiFab>>& vars_new)
+{
+    BL_PROFILE("ERF::Probes::sample");
+
+    const int npts  = m_x.size();
+    const int nvars = m_vars.size();
+    const int myproc = ParallelDescriptor::MyProc();
+
+    // Assign each point to the grid containing it on the finest level possible;
+    //     we keep only the points in grids owned by this rank
+    std::map<std::pair<int,int>, Vector<int>> local_pts;
+    for (int ip = 0; ip < npts; ++ip)
+    {
+        for (int lev = grids.size()-1; lev >= 0; --lev)
+        {
+            const Box& domain = m_geom[lev].Domain();
+            const Real* prob_lo = m_geom[lev].ProbLo();
+            const auto dxi = m_geom[lev].InvCellSizeArray();
+            const Real pos[AMREX_SPACEDIM] = {m_x[ip], m_y[ip], m_z[ip]};
+
+            IntVect iv;
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                iv[d] = domain.smallEnd(d) + static_cast<int>(Math::floor((pos[d] - prob_lo[d]) * dxi[d]));
+                iv[d] = amrex::min(amrex::max(iv[d], domain.smallEnd(d)), domain.bigEnd(d));
+            }
+
+            const auto isects = grids[lev].intersections(Box(iv,iv), true, 0);
+            if (!isects.empty()) {
+                const int ibox = isects[0].first;
+                if (vars_new[lev][Vars::cons].DistributionMap()[ibox] == myproc) {
+                    local_pts[{lev,ibox}].push_back(ip);
+                }
+                break;
+            }
+        }
+    }
+
+    Vector<Real> values(npts*nvars, 0.0);
+
+    Gpu::DeviceVector<int> d_vars(nvars);
+    Gpu::copy(Gpu::hostToDevice, m_vars.begin(), m_vars.end(), d_vars.begin());
+    const int* vars = d_vars.data();
+
+    for (const auto& lp : local_pts)
+    {
+        const int lev  = lp.first.first;
+        const int ibox = lp.first.second;
+        const Vector<int>& ids = lp.second;
+        const int n = ids.size();
+
+        // The stencil may reach one cell into the ghost cells of the grid; these were
+        //     filled at the end of the last advance
+        const Array4<const Real> s = vars_new[lev][Vars::cons][ibox].const_array();
+        const Array4<const Real> u = vars_new[lev][Vars::xvel][ibox].const_array();
+        const Array4<const Real> v = vars_new[lev][Vars::yvel][ibox].const_array();
+        const Array4<const Real> w = vars_new[lev][Vars::zvel][ibox].const_array();
+
+        const auto plo    = m_geom[lev].ProbLoArray();
+        const auto dxi    = m_geom[lev].InvCellSizeArray();
+        const auto dom_lo = lbound(m_geom[lev].Domain());
+
+        Vector<Real> h_pos(3*n);
+        for (int m = 0; m < n; ++m) {
+            h_pos[3*m  ] = m_x[ids[m]];
+            h_pos[3*m+1] = m_y[ids[m]];
+            h_pos[3*m+2] = m_z[ids[m]];
+        }
+        Gpu::DeviceVector<Real> d_pos(3*n);
+        Gpu::DeviceVector<Real> d_out(n*nvars);
+        Gpu::copy(Gpu::hostToDevice, h_pos.begin(), h_pos.end(), d_pos.begin());
+        const Real* pos = d_pos.data();
+        Real* out = d_out.data();
+
+        ParallelFor(n, [=] AMREX_GPU_DEVICE (int m) noexcept
+        {
+            const int lo[3] = {dom_lo.x, dom_lo.y, dom_lo.z};
+            for (int iv = 0; iv < nvars; ++iv)
+            {
+                const int var = vars[iv];
+
+                // Index-space location of the point relative to where the variable lives:
+                //     faces in the direction of the velocity component, cell centers otherwise
+                int ii[3];
+                Real wt[3];
+                for (int d = 0; d < 3; ++d) {
+                    Real xi = (pos[3*m+d] - plo[d]) * dxi[d] + lo[d];
+                    if (var != d) xi -= 0.5;
+                    ii[d] = static_cast<int>(Math::floor(xi));
+                    wt[d] = xi - ii[d];
+                }
+
+                Real val = 0.0;
+                for (int c = 0; c < 8; ++c) {
+                    const int di = c & 1;
+                    const int dj = (c >> 1) & 1;
+                    const int dk = (c >> 2) & 1;
+                    const Real fac = (di ? wt[0] : 1.0-wt[0]) *
+                                     (dj ? wt[1] : 1.0-wt[1]) *
+                                     (dk ? wt[2] : 1.0-wt[2]);
+                    const int i = ii[0]+di;
+                    const int j = ii[1]+dj;
+                    const int k = ii[2]+dk;
+                    Real f;
+                    if        (var == Probes::x_velocity) { f = u(i,j,k);
+                    } else if (var == Probes::y_velocity) { f = v(i,j,k);
+                    } else if (var == Probes::z_velocity) { f = w(i,j,k);
+                    } else                                { f = cc_value(var, s, i, j, k);
+                    }
+                    val += fac * f;
+                }
+                out[m*nvars+iv] = val;
+            }
+        });
+
+        Vector<Real> h_out(n*nvars);
+        Gpu::copy(Gpu::deviceToHost, d_out.begin(), d_out.end(), h_out.begin());
+        for (int m = 0; m < n; ++m) {
+            for (int iv = 0; iv < nvars; ++iv) {
+                values[ids[m]*nvars+iv] = h_out[m*nvars+iv];
+            }
+        }
+    }
+
+    // Every point is sampled by exactly one rank, so a single sum gathers them all
+    ParallelDescriptor::ReduceRealSum(values.dataPtr(), values.size(),
+                                      ParallelDescriptor::IOProcessorNumber());
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        const char* p_step = reinterpret_cast<const char*>(&t_step);
+        const char* p_time = reinterpret_cast<const char*>(&time);
+        const char* p_vals = reinterpret_cast<const char*>(values.data());
+        m_buf.insert(m_buf.end(), p_step, p_step+sizeof(int));
+        m_buf.insert(m_buf.end(), p_time, p_time+sizeof(Real));
+        m_buf.insert(m_buf.end(), p_vals, p_vals+values.size()*sizeof(Real));
+        ++m_nbuf;
+
+        if (m_nbuf >= m_buffer_size) flush();
+    }
+}
+
+void
+Probes::flush ()
+{
+    if (!m_ofs || m_nbuf == 0) return;
+
+    m_ofs->write(m_buf.data(), m_buf.size());
+    m_ofs->flush();
+
+    m_buf.clear();
+    m_nbuf = 0;
+}
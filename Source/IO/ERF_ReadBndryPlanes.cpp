@@ -154,8 +154,13 @@ ReadBndryPlanes::ReadBndryPlanes(const Geometry& geom): m_geom(geom)
             if (m_var_names[i] == "qv")           is_qv_read = 1;
             if (m_var_names[i] == "qc")           is_qc_read = 1;
 #endif
+#ifndef ERF_NO_TKE
             if (m_var_names[i] == "KE")           is_KE_read = 1;
             if (m_var_names[i] == "QKE")          is_QKE_read = 1;
+#else
+            if (m_var_names[i] == "KE" || m_var_names[i] == "QKE")
+                Error("ReadBndryPlanes: KE and QKE are not available when built with ERF_NO_TKE");
+#endif
         }
     }
 
@@ -361,8 +366,10 @@ void ReadBndryPlanes::read_file(const int idx, Vector<std::unique_ptr<PlaneVecto
         if (var_name == "density")     n_offset = BCVars::Rho_bc_comp;
         if (var_name == "theta")       n_offset = BCVars::RhoTheta_bc_comp;
         if (var_name == "temperature") n_offset = BCVars::RhoTheta_bc_comp;
+#ifndef ERF_NO_TKE
         if (var_name == "KE")          n_offset = BCVars::RhoKE_bc_comp;
         if (var_name == "QKE")         n_offset = BCVars::RhoQKE_bc_comp;
+#endif
         if (var_name == "scalar")      n_offset = BCVars::RhoScalar_bc_comp;
 #ifdef ERF_USE_MOISTURE
         if (var_name == "qv")          n_offset = BCVars::RhoQv_bc_comp;
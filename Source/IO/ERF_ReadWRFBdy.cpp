@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cstdio>
+
+#include "AMReX_ParmParse.H"
+#include "AMReX_ParallelDescriptor.H"
+#include "ERF_ReadWRFBdy.H"
+#include "NCInterface.H"
+
+using namespace amrex;
+
+namespace {
+
+//! Days from 1970-01-01 to the (proleptic Gregorian) date y-m-d
+long days_from_civil (long y, int m, int d)
+{
+    y -= m <= 2;
+    const long era = (y >= 0 ? y : y - 399) / 400;
+    const long yoe = y - era * 400;
+    const long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+//! Seconds since 1970-01-01 of a WRF time stamp "YYYY-MM-DD_HH:MM:SS"
+Real seconds_from_timestamp (const std::string& ts)
+{
+    int yr, mo, dy, hr, mn, sc;
+    if (std::sscanf(ts.c_str(), "%d-%d-%d_%d:%d:%d", &yr, &mo, &dy, &hr, &mn, &sc) != 6) {
+        Abort("ReadWRFBdy: cannot parse time stamp " + ts);
+    }
+    return static_cast<Real>(days_from_civil(yr, mo, dy)) * 86400.0 + hr * 3600.0 + mn * 60.0 + sc;
+}
+
+//! Return closest index (from lower) of value in vector
+int
+closest_index (const Vector<Real>& vec, const Real value)
+{
+    auto const it = std::upper_bound(vec.begin(), vec.end(), value);
+    AMREX_ALWAYS_ASSERT(it != vec.end());
+
+    const int idx = std::distance(vec.begin(), it);
+    return std::max(idx - 1, 0);
+}
+
+}
+
+ReadWRFBdy::ReadWRFBdy (const std::string& fname, const Geometry& geom,
+                        const BoxArray& ba, const DistributionMapping& dm,
+                        int ngrow)
+    : m_filename(fname), m_geom(geom)
+{
+    ParmParse pp("erf");
+    pp.query("wrfbdy_prefetch", m_prefetch);
+
+    // *********************************************************
+    // Find the part of each lateral strip next to the grids we own.
+    // The strips hold all the variables, so they are one longer than
+    // the domain in the tangential and vertical directions to hold
+    // the staggered ones.
+    // *********************************************************
+    const Box& domain = m_geom.Domain();
+    const int myproc = ParallelDescriptor::MyProc();
+
+    m_strip.resize(NumBdyFaces);
+    for (int f = 0; f < NumBdyFaces; ++f)
+    {
+        const int  normal  = f / 2;
+        const bool is_high = (f % 2 == 1);
+        const int  plane   = is_high ? domain.bigEnd(normal) + 1 : domain.smallEnd(normal) - 1;
+
+        Box full(domain);
+        full.growHi(0, 1).growHi(1, 1).growHi(2, 1);
+        full.setRange(normal, plane, 1);
+
+        Box needed;
+        for (int i = 0; i < ba.size(); ++i)
+        {
+            if (dm[i] != myproc) continue;
+
+            Box gbx = amrex::grow(ba[i], ngrow);
+            gbx.growHi(0, 1).growHi(1, 1).growHi(2, 1);
+
+            const bool touches = is_high ? (gbx.bigEnd(normal)   >  domain.bigEnd(normal))
+                                         : (gbx.smallEnd(normal) <  domain.smallEnd(normal));
+            if (!touches) continue;
+
+            // Values beyond the ends of the strip are clamped onto it
+            gbx.setRange(normal, plane, 1);
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                if (d == normal) continue;
+                gbx.setSmall(d, std::max(gbx.smallEnd(d), full.smallEnd(d)));
+                gbx.setBig  (d, std::max(gbx.smallEnd(d), std::min(gbx.bigEnd(d), full.bigEnd(d))));
+            }
+            gbx &= full;
+
+            needed = needed.ok() ? amrex::minBox(needed, gbx) : gbx;
+        }
+        m_strip[f] = needed;
+    }
+
+    auto alloc = [&] (Vector<FArrayBox>& data, Arena* ar)
+    {
+        data.resize(NumBdyFaces);
+        for (int f = 0; f < NumBdyFaces; ++f) {
+            if (m_strip[f].ok()) {
+                data[f].resize(m_strip[f], NumBdyVars, ar);
+            }
+        }
+    };
+    alloc(m_data_n     , The_Arena());
+    alloc(m_data_np1   , The_Arena());
+    alloc(m_data_np2   , The_Arena());
+    alloc(m_data_interp, The_Arena());
+    alloc(m_host_data  , The_Pinned_Arena());
+
+    read_times();
+}
+
+ReadWRFBdy::~ReadWRFBdy ()
+{
+    wait_for_prefetch();
+}
+
+void
+ReadWRFBdy::read_times ()
+{
+    BL_PROFILE("ERF::ReadWRFBdy::read_times");
+
+    int ntimes = 0;
+    Vector<Real> times;
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        auto ncf = ncutils::NCFile::open(m_filename, NC_NOWRITE);
+
+        ntimes = static_cast<int>(ncf.dim("Time").len());
+        const int len = static_cast<int>(ncf.dim("DateStrLen").len());
+
+        std::vector<char> stamps(ntimes * len);
+        ncf.var("Times").get(stamps.data(), {0, 0}, {size_t(ntimes), size_t(len)});
+        ncf.close();
+
+        times.resize(ntimes);
+        for (int n = 0; n < ntimes; ++n) {
+            times[n] = seconds_from_timestamp(std::string(stamps.data() + n * len, len));
+        }
+
+        // Times are measured from the first boundary time, which is also the start of the run
+        const Real t0 = times[0];
+        for (int n = 0; n < ntimes; ++n) {
+            times[n] -= t0;
+        }
+        for (int n = 1; n < ntimes; ++n) {
+            if (times[n] <= times[n-1]) Error("ReadWRFBdy: times in the wrfbdy file must increase");
+        }
+        if (ntimes < 2) Error("ReadWRFBdy: the wrfbdy file must hold at least two times");
+    }
+
+    ParallelDescriptor::Bcast(&ntimes, 1, ParallelDescriptor::IOProcessorNumber());
+    times.resize(ntimes);
+    ParallelDescriptor::Bcast(times.data(), ntimes, ParallelDescriptor::IOProcessorNumber());
+
+    m_in_times = times;
+
+    amrex::Print() << "Found " << ntimes << " times in the wrfbdy file " << m_filename
+                   << " spanning " << m_in_times.back() << " seconds" << std::endl;
+}
+
+void
+ReadWRFBdy::read_time_level (int itime, Vector<FArrayBox>& host_data) const
+{
+    bool have_strips = false;
+    for (int f = 0; f < NumBdyFaces; ++f) {
+        have_strips = have_strips || m_strip[f].ok();
+    }
+
+    // Ranks not owning any grid next to the lateral boundaries don't touch the file
+    if (!have_strips) return;
+
+    static const std::string var_prefix[NumBdyVars]  = {"U", "V", "W", "T"};
+    static const std::string face_suffix[NumBdyFaces] = {"_BXS", "_BXE", "_BYS", "_BYE"};
+
+    const Box& domain = m_geom.Domain();
+
+    auto ncf = ncutils::NCFile::open(m_filename, NC_NOWRITE);
+
+    std::vector<float> buffer;
+
+    for (int f = 0; f < NumBdyFaces; ++f)
+    {
+        if (!m_strip[f].ok()) continue;
+
+        FArrayBox& fab = host_data[f];
+        fab.setVal<RunOn::Host>(0.0);
+
+        // The direction along the face
+        const int tang = (f / 2 == 0) ? 1 : 0;
+
+        for (int v = 0; v < NumBdyVars; ++v)
+        {
+            // Only the velocity along the face and W are staggered along the strip
+            const bool tang_stag = (v == U && tang == 0) || (v == V && tang == 1);
+            const bool vert_stag = (v == W);
+
+            Box vbx(m_strip[f]);
+            vbx.setBig(tang, std::min(vbx.bigEnd(tang), domain.bigEnd(tang) + (tang_stag ? 1 : 0)));
+            vbx.setBig(2   , std::min(vbx.bigEnd(2)   , domain.bigEnd(2)    + (vert_stag ? 1 : 0)));
+            if (!vbx.ok()) continue;
+
+            // NetCDF dimensions are (Time, bdy_width, bottom_top, south_north or west_east);
+            //    we only need the row next to the domain
+            std::vector<size_t> start{size_t(itime), 0,
+                                      size_t(vbx.smallEnd(2)    - domain.smallEnd(2)),
+                                      size_t(vbx.smallEnd(tang) - domain.smallEnd(tang))};
+            std::vector<size_t> count{1, 1, size_t(vbx.length(2)), size_t(vbx.length(tang))};
+
+            buffer.resize(vbx.numPts());
+            ncf.var(var_prefix[v] + face_suffix[f]).get(buffer.data(), start, count);
+
+            // With the normal direction of length one the slab is in FAB order
+            const Array4<Real> arr = fab.array(v);
+            const auto lo = lbound(vbx);
+            const auto hi = ubound(vbx);
+            Long m = 0;
+            for (int k = lo.z; k <= hi.z; ++k) {
+            for (int j = lo.y; j <= hi.y; ++j) {
+            for (int i = lo.x; i <= hi.x; ++i) {
+                arr(i,j,k) = static_cast<Real>(buffer[m++]);
+            }
+            }
+            }
+        }
+    }
+    ncf.close();
+}
+
+void
+ReadWRFBdy::start_prefetch (int itime)
+{
+    if (!m_prefetch || itime >= m_in_times.size()) return;
+
+    m_prefetch_idx = itime;
+    m_future = std::async(std::launch::async, [this, itime] () {
+        read_time_level(itime, m_host_data);
+    });
+}
+
+void
+ReadWRFBdy::wait_for_prefetch ()
+{
+    if (m_future.valid()) m_future.get();
+}
+
+void
+ReadWRFBdy::load_time_level (int itime, Vector<FArrayBox>& data)
+{
+    BL_PROFILE("ERF::ReadWRFBdy::load_time_level");
+
+    if (itime == m_prefetch_idx) {
+        wait_for_prefetch();
+    } else {
+        wait_for_prefetch();
+        read_time_level(itime, m_host_data);
+    }
+    m_prefetch_idx = -1;
+
+    for (int f = 0; f < NumBdyFaces; ++f) {
+        if (m_strip[f].ok()) {
+            data[f].copy<RunOn::Device>(m_host_data[f]);
+        }
+    }
+    Gpu::streamSynchronize();
+}
+
+void
+ReadWRFBdy::read_input_files (Real time, Real dt)
+{
+    BL_PROFILE("ERF::ReadWRFBdy::read_input_files");
+
+    // Assert that both the current time and the next time are within the bounds
+    // of the data that we can read
+    AMREX_ALWAYS_ASSERT((m_in_times[0] <= time) && (time <= m_in_times.back()));
+    AMREX_ALWAYS_ASSERT((m_in_times[0] <= time+dt) && (time+dt <= m_in_times.back()));
+
+    const int ntimes = m_in_times.size();
+
+    // The first time we enter this routine we read the first three time levels
+    //    (or two if that is all there is)
+    if (last_file_read == -1)
+    {
+        const int n2 = std::min(2, ntimes-1);
+
+        load_time_level(0, m_data_n);
+        m_tn = m_in_times[0];
+
+        load_time_level(1, m_data_np1);
+        m_tnp1 = m_in_times[1];
+
+        load_time_level(n2, m_data_np2);
+        m_tnp2 = m_in_times[n2];
+
+        // We want to start with this filled
+        for (int f = 0; f < NumBdyFaces; ++f) {
+            if (m_strip[f].ok()) m_data_interp[f].copy<RunOn::Device>(m_data_n[f]);
+        }
+        m_tinterp = m_tn;
+
+        last_file_read = n2;
+        start_prefetch(last_file_read+1);
+    }
+
+    // Compute the index such that time falls between times[idx] and times[idx+1]
+    const int idx = closest_index(m_in_times, time);
+
+    // Now we need another time level -- which is usually already on its way
+    while (idx >= last_file_read-1 && last_file_read != ntimes-1)
+    {
+        const int new_read = last_file_read+1;
+
+        // This doesn't actually move the data, just swaps the FABs
+        std::swap(m_data_n  , m_data_np1);
+        std::swap(m_data_np1, m_data_np2);
+
+        m_tn   = m_tnp1;
+        m_tnp1 = m_tnp2;
+        m_tnp2 = m_in_times[new_read];
+
+        load_time_level(new_read, m_data_np2);
+        last_file_read = new_read;
+
+        start_prefetch(last_file_read+1);
+    }
+
+    AMREX_ASSERT(time    >= m_tn && time    <= m_tnp2);
+    AMREX_ASSERT(time+dt >= m_tn && time+dt <= m_tnp2);
+}
+
+Vector<FArrayBox>&
+ReadWRFBdy::interp_in_time (Real time)
+{
+    AMREX_ALWAYS_ASSERT(m_tn <= time && time <= m_tnp2);
+
+    if (time == m_tinterp) {
+        // We have already interpolated to this time
+        return m_data_interp;
+    }
+
+    m_tinterp = time;
+
+    const bool first_interval = (time < m_tnp1);
+    const Vector<FArrayBox>& dat0 = first_interval ? m_data_n   : m_data_np1;
+    const Vector<FArrayBox>& dat1 = first_interval ? m_data_np1 : m_data_np2;
+    const Real t0 = first_interval ? m_tn   : m_tnp1;
+    const Real t1 = first_interval ? m_tnp1 : m_tnp2;
+
+    for (int f = 0; f < NumBdyFaces; ++f) {
+        if (!m_strip[f].ok()) continue;
+        if (t1 <= t0) {
+            // Only happens past the last time when the file holds just two of them
+            m_data_interp[f].copy<RunOn::Device>(dat1[f]);
+        } else {
+            m_data_interp[f].linInterp<RunOn::Device>(dat0[f], 0, dat1[f], 0, t0, t1, m_tinterp,
+                                                      m_strip[f], 0, NumBdyVars);
+        }
+    }
+    return m_data_interp;
+}
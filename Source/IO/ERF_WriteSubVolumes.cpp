@@ -0,0 +1,243 @@
+#include "AMReX_Gpu.H"
+#include "AMReX_ParmParse.H"
+#include "AMReX_Utility.H"
+#include "ERF_WriteSubVolumes.H"
+#include "IndexDefines.H"
+#include "Derive.H"
+
+using namespace amrex;
+
+WriteSubVolumes::WriteSubVolumes (const Vector<Geometry>& geom): m_geom(geom)
+{
+    ParmParse pp("erf");
+
+    pp.query("sample_dir", m_dirname);
+
+    int num_samples = pp.countval("sample_names");
+    Vector<std::string> names(num_samples);
+    pp.queryarr("sample_names", names, 0, num_samples);
+
+    const Real* prob_lo = geom[0].ProbLo();
+    const Real* prob_hi = geom[0].ProbHi();
+
+    for (const auto& name : names)
+    {
+        ParmParse pps("erf." + name);
+
+        Sample s;
+        s.name = name;
+        pps.get("type", s.type);
+
+        // Start from the whole domain and collapse the thin directions
+        Array<Real,AMREX_SPACEDIM> lo{AMREX_D_DECL(prob_lo[0],prob_lo[1],prob_lo[2])};
+        Array<Real,AMREX_SPACEDIM> hi{AMREX_D_DECL(prob_hi[0],prob_hi[1],prob_hi[2])};
+
+        if (s.type == "plane") {
+            int normal; Real loc;
+            pps.get("normal", normal);
+            pps.get("loc", loc);
+            AMREX_ALWAYS_ASSERT(normal >= 0 && normal < AMREX_SPACEDIM);
+            lo[normal] = hi[normal] = loc;
+        } else if (s.type == "line") {
+            // loc holds the coordinates of the line in the two other directions (in increasing order)
+            int dir;
+            Vector<Real> loc(AMREX_SPACEDIM-1);
+            pps.get("dir", dir);
+            pps.getarr("loc", loc, 0, AMREX_SPACEDIM-1);
+            AMREX_ALWAYS_ASSERT(dir >= 0 && dir < AMREX_SPACEDIM);
+            for (int d = 0, n = 0; d < AMREX_SPACEDIM; ++d) {
+                if (d != dir) { lo[d] = hi[d] = loc[n++]; }
+            }
+        } else if (s.type == "box") {
+            Vector<Real> box_lo(AMREX_SPACEDIM), box_hi(AMREX_SPACEDIM);
+            pps.getarr("lo", box_lo, 0, AMREX_SPACEDIM);
+            pps.getarr("hi", box_hi, 0, AMREX_SPACEDIM);
+            for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+                lo[d] = box_lo[d];
+                hi[d] = box_hi[d];
+            }
+        } else {
+            Error("WriteSubVolumes: sample type must be plane, line or box");
+        }
+        s.region = RealBox(lo, hi);
+
+        pps.getarr("var_names", s.var_names, 0, pps.countval("var_names"));
+        pps.query("interval", s.interval);
+        pps.query("per", s.per);
+        if (s.interval <= 0 && s.per <= 0.0) {
+            Error("WriteSubVolumes: must specify interval or per for sample " + name);
+        }
+
+        m_samples.push_back(std::move(s));
+    }
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        if (!UtilCreateDirectory(m_dirname, 0755)) CreateDirectoryFailed(m_dirname);
+
+        for (auto& s : m_samples)
+        {
+            // The header describes the sample; each record in the data file is
+            //     t_step time lev box_lo box_hi ncomp data
+            // with the data of each variable stored contiguously in Fortran order
+            std::ofstream hdr(m_dirname + "/" + s.name + ".hdr");
+            hdr.precision(17);
+            hdr << s.name << ' ' << s.type << '\n';
+            hdr << s.region << '\n';
+            hdr << s.var_names.size();
+            for (const auto& v : s.var_names) hdr << ' ' << v;
+            hdr << '\n';
+            hdr << sizeof(Real) << '\n';
+
+            // Append so that restarted runs continue the same time series
+            s.ofs = std::make_unique<std::ofstream>(m_dirname + "/" + s.name + ".bin",
+                                                    std::ios::out | std::ios::app | std::ios::binary);
+            if (!s.ofs->good()) FileOpenFailed(m_dirname + "/" + s.name + ".bin");
+        }
+    }
+}
+
+Box
+WriteSubVolumes::sample_box (const Sample& s, int lev) const
+{
+    const Box& domain = m_geom[lev].Domain();
+    const Real* prob_lo = m_geom[lev].ProbLo();
+    const auto dxi = m_geom[lev].InvCellSizeArray();
+
+    IntVect lo, hi;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        lo[d] = static_cast<int>(Math::floor((s.region.lo(d) - prob_lo[d]) * dxi[d]));
+        if (s.region.hi(d) > s.region.lo(d)) {
+            hi[d] = static_cast<int>(Math::ceil((s.region.hi(d) - prob_lo[d]) * dxi[d])) - 1;
+        } else {
+            hi[d] = lo[d];
+        }
+        lo[d] = amrex::max(domain.smallEnd(d), amrex::min(domain.bigEnd(d), lo[d]));
+        hi[d] = amrex::max(lo[d],              amrex::min(domain.bigEnd(d), hi[d]));
+    }
+    return Box(lo, hi);
+}
+
+void
+WriteSubVolumes::write_sample (int isamp, int t_step, Real time,
+                               const Vector<BoxArray>& grids,
+                               Vector<Vector<MultiFab>>& vars_new)
+{
+    BL_PROFILE("ERF::WriteSubVolumes::write_sample");
+
+    Sample& s = m_samples[isamp];
+    const int ncomp = s.var_names.size();
+
+    // Use the finest level that holds the whole sample
+    int lev = 0;
+    for (int ilev = grids.size()-1; ilev > 0; --ilev) {
+        if (grids[ilev].contains(sample_box(s, ilev))) {
+            lev = ilev;
+            break;
+        }
+    }
+    const Box target_box = sample_box(s, lev);
+
+    const MultiFab& S = vars_new[lev][Vars::cons];
+    const DistributionMapping& dm = S.DistributionMap();
+
+    // Only the grids intersecting the sample contribute, each on the rank that owns it
+    const auto isects = S.boxArray().intersections(target_box);
+
+    BoxList bl;
+    Vector<int> pmap;
+    for (const auto& is : isects) {
+        bl.push_back(is.second);
+        pmap.push_back(dm[is.first]);
+    }
+
+    MultiFab dst(BoxArray(target_box),
+                 DistributionMapping(Vector<int>{ParallelDescriptor::IOProcessorNumber()}),
+                 ncomp, 0, MFInfo().SetArena(The_Pinned_Arena()));
+
+    if (!isects.empty())
+    {
+        BoxArray sba(bl);
+        DistributionMapping sdm(pmap);
+        MultiFab smf(sba, sdm, ncomp, 0);
+
+        for (MFIter mfi(smf); mfi.isValid(); ++mfi)
+        {
+            const Box& bx = mfi.validbox();
+            const int src = isects[mfi.index()].first;
+
+            FArrayBox& dfab = smf[mfi];
+            const FArrayBox& sfab = S[src];
+
+            for (int n = 0; n < ncomp; ++n)
+            {
+                const std::string& var = s.var_names[n];
+                const Array4<Real> d_arr = dfab.array(n);
+
+                // The derive functions always fill the first component of the fab they are given
+                FArrayBox dfab_n(dfab, amrex::make_alias, n, 1);
+
+                auto copy_comp = [&] (int comp)
+                {
+                    const Array4<const Real> s_arr = sfab.const_array();
+                    ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                        d_arr(i,j,k) = s_arr(i,j,k,comp);
+                    });
+                };
+
+                auto avg_face = [&] (int var_idx, int dir)
+                {
+                    const Array4<const Real> v_arr = vars_new[lev][var_idx][src].const_array();
+                    const IntVect off = IntVect::TheDimensionVector(dir);
+                    ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                        d_arr(i,j,k) = 0.5 * (v_arr(i,j,k) + v_arr(i+off[0],j+off[1],k+off[2]));
+                    });
+                };
+
+                if        (var == "density")  { copy_comp(Rho_comp);
+                } else if (var == "rhotheta") { copy_comp(RhoTheta_comp);
+#ifndef ERF_NO_TKE
+                } else if (var == "rhoKE")    { copy_comp(RhoKE_comp);
+                } else if (var == "rhoQKE")   { copy_comp(RhoQKE_comp);
+#endif
+                } else if (var == "rhoadv_0") { copy_comp(RhoScalar_comp);
+#ifdef ERF_USE_MOISTURE
+                } else if (var == "rhoQv")    { copy_comp(RhoQv_comp);
+                } else if (var == "rhoQc")    { copy_comp(RhoQc_comp);
+#endif
+                } else if (var == "x_velocity") { avg_face(Vars::xvel, 0);
+                } else if (var == "y_velocity") { avg_face(Vars::yvel, 1);
+                } else if (var == "z_velocity") { avg_face(Vars::zvel, 2);
+                } else if (var == "pressure")   { derived::erf_derpres      (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+                } else if (var == "soundspeed") { derived::erf_dersoundspeed(bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+                } else if (var == "temp")       { derived::erf_dertemp      (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+                } else if (var == "theta")      { derived::erf_dertheta     (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+#ifndef ERF_NO_TKE
+                } else if (var == "KE")         { derived::erf_derKE        (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+                } else if (var == "QKE")        { derived::erf_derQKE       (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+#endif
+                } else if (var == "scalar")     { derived::erf_derscalar    (bx, dfab_n, 0, 1, sfab, m_geom[lev], time, nullptr, lev);
+                } else {
+                    Error("WriteSubVolumes: don't know how to output variable " + var);
+                }
+            }
+        }
+
+        dst.ParallelCopy(smf, 0, 0, ncomp);
+    }
+    Gpu::streamSynchronize();
+
+    if (ParallelDescriptor::IOProcessor())
+    {
+        std::ofstream& ofs = *s.ofs;
+        const FArrayBox& fab = dst[0];
+        ofs.write(reinterpret_cast<const char*>(&t_step), sizeof(int));
+        ofs.write(reinterpret_cast<const char*>(&time), sizeof(Real));
+        ofs.write(reinterpret_cast<const char*>(&lev), sizeof(int));
+        ofs.write(reinterpret_cast<const char*>(target_box.loVect()), AMREX_SPACEDIM*sizeof(int));
+        ofs.write(reinterpret_cast<const char*>(target_box.hiVect()), AMREX_SPACEDIM*sizeof(int));
+        ofs.write(reinterpret_cast<const char*>(&ncomp), sizeof(int));
+        ofs.write(reinterpret_cast<const char*>(fab.dataPtr()), fab.nBytes());
+        ofs.flush();
+    }
+}
@@ -13,6 +13,39 @@ using namespace amrex;
 
 using PlaneVector = amrex::Vector<amrex::FArrayBox>;
 
+// Copy values read from a NetCDF variable into component comp of a (host) FAB over the box bx.
+// src holds bx.numPts() values with west_east varying fastest, then south_north, then bottom_top --
+//    which is the FAB order, so each (j,k) row is one contiguous block converted with unit stride.
+//    The rows are shared among the threads.
+void
+ConvertNCDataToFAB(const float* src, const Box& bx, FArrayBox& fab, int comp)
+{
+    AMREX_ALWAYS_ASSERT(fab.box().contains(bx));
+
+    const auto lo  = amrex::lbound(bx);
+    const auto len = amrex::length(bx);
+    const Array4<Real> dst = fab.array(comp);
+
+    const Long nrows = Long(len.y) * len.z;
+
+#ifdef _OPENMP
+#pragma omp parallel for if (nrows > 1)
+#endif
+    for (Long row = 0; row < nrows; ++row)
+    {
+        const int j = lo.y + static_cast<int>(row % len.y);
+        const int k = lo.z + static_cast<int>(row / len.y);
+
+        const float* AMREX_RESTRICT s = src + row * len.x;
+        Real*        AMREX_RESTRICT d = dst.ptr(lo.x, j, k);
+
+        AMREX_PRAGMA_SIMD
+        for (int i = 0; i < len.x; ++i) {
+            d[i] = static_cast<Real>(s[i]);
+        }
+    }
+}
+
 // Function to read a NetCDF variable and fill a corresponding MultiFab and Array4
 // fname is the "wrfinput_d01" resulting from running ideal.exe or real.exe
 void
@@ -73,194 +106,83 @@ BuildFABsFromWRFInputFile(const std::string &fname,
 
             AMREX_ALWAYS_ASSERT(bx == fab_vars[i]->box());
 
-            int ncomp  = 1;
-            auto num_pts = fab_vars[i]->box().numPts();
-            for (int k(0); k < ncomp; ++k) {
-                auto dataPtr = fab_vars[i]->dataPtr(k);
-                for (int n(0); n < num_pts; ++n) {
-                    *(dataPtr+n) = static_cast<Real>(*(arrays[i].get_data()+n));
-//                    if (n % 5000 == 0)
-//                        //amrex::Print() << "n: " << n << ", data[n]: " << *(dataPtr+n) << std::endl;
-//                        amrex::Print() << "n: " << n << ", data[n]: " << *(arrays[i].get_data()+n) << std::endl;
-                }
-            }
+            // Fetch the data pointer once: get_data() bumps the reference count on every call
+            ConvertNCDataToFAB(arrays[i].get_data(), bx, *fab_vars[i], 0);
         }
     } // if IOProcessor
 }
 
-int
-BuildFABsFromWRFBdyFile(const std::string &fname,
-                        amrex::Vector<FArrayBox>& bdy_data_xlo,
-                        amrex::Vector<FArrayBox>& bdy_data_xhi,
-                        amrex::Vector<FArrayBox>& bdy_data_ylo,
-                        amrex::Vector<FArrayBox>& bdy_data_yhi)
+// Function to read, on every rank, only the parts of NetCDF variables of dimensions
+//    Time_BT_SN_WE that overlap the FABs owned by this rank.
+// fname is the "wrfinput_d01" resulting from running ideal.exe or real.exe
+// fab_vars[i] holds the FABs to be filled with variable nc_var_names[i]; the index type of each
+//    FAB determines the staggering of the variable.
+// file_lo is the index (at the level of the FABs) of the first cell in the file.
+// On return read_boxes[i][n] is the part of fab_vars[i][n] that has been filled (empty if none).
+void
+ReadWRFInputHyperslabs(const std::string &fname,
+                       const Vector<std::string>& nc_var_names,
+                       const Vector<Vector<FArrayBox*>>& fab_vars,
+                       const IntVect& file_lo,
+                       Vector<Vector<Box>>& read_boxes)
 {
-    int ntimes;
-    if (amrex::ParallelDescriptor::IOProcessor())
-    {
-        // We only read in data at one resolution, which we assume to be that of level 0
-        //int lev = 0;
+    AMREX_ALWAYS_ASSERT(fab_vars.size() == nc_var_names.size());
 
-        Vector<std::string> nc_var_names;
-        Vector<enum NC_Data_Dims_Type> NC_dim_types;
-        Vector<enum Stagger> staggerDir;
+    read_boxes.resize(nc_var_names.size());
 
-        nc_var_names.push_back("U_BXS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("U_BXE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("U_BYS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::x);
-        nc_var_names.push_back("U_BYE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::x);
+    bool have_fabs = false;
+    for (int i = 0; i < nc_var_names.size(); i++) {
+        read_boxes[i].clear();
+        read_boxes[i].resize(fab_vars[i].size());
+        have_fabs = have_fabs || !fab_vars[i].empty();
+    }
 
-        nc_var_names.push_back("V_BXS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::y);
-        nc_var_names.push_back("V_BXE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::y);
-        nc_var_names.push_back("V_BYS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("V_BYE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::None);
+    // Ranks owning no grids at this level don't touch the file
+    if (!have_fabs) return;
 
-        nc_var_names.push_back("W_BXS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::z);
-        nc_var_names.push_back("W_BXE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::z);
-        nc_var_names.push_back("W_BYS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::z);
-        nc_var_names.push_back("W_BYE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::z);
+    auto ncf = ncutils::NCFile::open(fname, NC_NOWRITE);
 
-        nc_var_names.push_back("T_BXS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("T_BXE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_SN);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("T_BYS")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::None);
-        nc_var_names.push_back("T_BYE")     ; NC_dim_types.push_back(NC_Data_Dims_Type::Time_BdyWidth_BT_WE);   staggerDir.push_back(Stagger::None);
+    std::vector<float> buffer;
 
-        using RARRAY = NDArray<float>;
-        amrex::Vector<RARRAY> arrays(nc_var_names.size());
-        ReadWRFBdyFile(fname, nc_var_names, arrays);
-
-        using CharArray = NDArray<char*>;
-        amrex::Vector<CharArray> array_ts(1);
-        //ReadWRFBdyFile(fname, {"Times"}, array_ts);
+    for (int i = 0; i < nc_var_names.size(); i++)
+    {
+        if (fab_vars[i].empty()) continue;
 
-        ntimes = arrays[0].get_vshape()[0];
+        auto ncvar = ncf.var(nc_var_names[i]);
+        std::vector<size_t> shape = ncvar.shape();
+        AMREX_ALWAYS_ASSERT(shape.size() == 4);
 
-        for (int i = 0; i < nc_var_names.size(); i++)
+        for (int n = 0; n < fab_vars[i].size(); n++)
         {
-            amrex::Print() << "Building FAB for the the NetCDF variable : " << nc_var_names[i] << std::endl;
+            FArrayBox& fab = *fab_vars[i][n];
 
-            auto shape_data = arrays[i].get_vshape();
-            auto currentVar = nc_var_names[i];
+            // The extent of the data in the file, with the same staggering as the FAB
+            const IntVect file_hi = file_lo + IntVect(static_cast<int>(shape[3]) - 1,
+                                                      static_cast<int>(shape[2]) - 1,
+                                                      static_cast<int>(shape[1]) - 1);
+            const Box file_box(file_lo, file_hi, fab.box().ixType());
 
-            // Build the box first using the shape information
-            amrex::IntVect smallEnd{0, 0, 0};
-            amrex::IntVect bigEnd{0, 0, 0};
+            const Box bx = fab.box() & file_box;
+            if (!bx.ok()) continue;
 
-            // get_vshape()[0] : number of times
-            // get_vshape()[1] : number of points in x-direction
-            // get_vshape()[2] : number of points in z-direction
-            // get_vshape()[3] : number of points in y-direction
-
-            // Assert that all data has the same number of time snapshots
-            AMREX_ALWAYS_ASSERT(arrays[i].get_vshape()[0] == ntimes);
-
-            /*
-            //TODO:
-             Should we use Vector<Vector<FArrayBox>> for bdy_data_xlo,
-             where the outer index is for time and inner is for variables = {U, V, W, T} with different stagger ?
-             */
-            // Add enough space to hold all the time snapshots
-            Box bx_xlo = bdy_data_xlo[0].box();
-            int nc_xlo = bdy_data_xlo[0].nComp();
-            for (int n = 1; n < ntimes; n++) {
-                bdy_data_xlo.push_back(amrex::FArrayBox(bx_xlo,nc_xlo));
-            }
-            Box bx_xhi = bdy_data_xhi[0].box();
-            int nc_xhi = bdy_data_xhi[0].nComp();
-            for (int n = 1; n < ntimes; n++) {
-                bdy_data_xhi.push_back(amrex::FArrayBox(bx_xhi,nc_xhi));
-            }
-            Box bx_ylo = bdy_data_ylo[0].box();
-            int nc_ylo = bdy_data_ylo[0].nComp();
-            for (int n = 1; n < ntimes; n++) {
-                bdy_data_ylo.push_back(amrex::FArrayBox(bx_ylo,nc_ylo));
-            }
-            Box bx_yhi = bdy_data_yhi[0].box();
-            int nc_yhi = bdy_data_yhi[0].nComp();
-            for (int n = 1; n < ntimes; n++) {
-                bdy_data_yhi.push_back(amrex::FArrayBox(bx_yhi,nc_yhi));
-            }
+            // NetCDF dimensions are (Time, bottom_top, south_north, west_east)
+            const IntVect off = bx.smallEnd() - file_lo;
+            const IntVect len = bx.length();
+            std::vector<size_t> start{0, size_t(off[2]), size_t(off[1]), size_t(off[0])};
+            std::vector<size_t> count{1, size_t(len[2]), size_t(len[1]), size_t(len[0])};
 
-            //
-            // NOTE: we always define the box here to be on the low side, but this won't matter
-            //       when we copy data into the FABs below.  It is only the shape that matters.
-            //
-            switch (NC_dim_types[i]) {
-                case NC_Data_Dims_Type::Time_BdyWidth_BT_SN: // lo-i and hi-i
-                    // amrex::Print() << "TYPE IS Time_BdyWidth_BT_SN " << std::endl;
-                    // amrex::Print() << "SHAPE 0 " << arrays[i].get_vshape()[0] << std::endl;
-                    // amrex::Print() << "SHAPE 1 " << arrays[i].get_vshape()[1] << std::endl;
-                    // amrex::Print() << "SHAPE 2 " << arrays[i].get_vshape()[2] << std::endl;
-                    // amrex::Print() << "SHAPE 3 " << arrays[i].get_vshape()[3] << std::endl;
-                    smallEnd[0] = -1;
-                    bigEnd[0]   = -1;
-                    bigEnd[1] = arrays[i].get_vshape()[3] - 1;
-                    bigEnd[2] = arrays[i].get_vshape()[2] - 1;
-                    break;
-                case NC_Data_Dims_Type::Time_BdyWidth_BT_WE: // lo-j and hi-j
-                    // amrex::Print() << "TYPE IS Time_BdyWidth_BT_WE " << std::endl;
-                    // amrex::Print() << "SHAPE 0 " << arrays[i].get_vshape()[0] << std::endl;
-                    // amrex::Print() << "SHAPE 1 " << arrays[i].get_vshape()[1] << std::endl;
-                    // amrex::Print() << "SHAPE 2 " << arrays[i].get_vshape()[2] << std::endl;
-                    // amrex::Print() << "SHAPE 3 " << arrays[i].get_vshape()[3] << std::endl;
-                    //bigEnd[0] = arrays[i].get_vshape()[1] - 1;
-                    bigEnd[0] = arrays[i].get_vshape()[3] - 1;
-                    smallEnd[1] = -1;
-                    bigEnd[1]   = -1;
-                    bigEnd[2] = arrays[i].get_vshape()[2] - 1;
-                    break;
-                case NC_Data_Dims_Type::Time_BT:
-                    bigEnd[0] = 0;
-                    bigEnd[1] = 0;
-                    bigEnd[2] = arrays[0].get_vshape()[1] - 1;
-                    break;
-                case NC_Data_Dims_Type::Time:
-                    bigEnd[0] = 0;
-                    bigEnd[1] = 0;
-                    bigEnd[2] = 0;
-                    break;
-                default:
-                    amrex::Error("Unrecognized NetCDF data dimensions type");
-            }
+            // The slab is contiguous with west_east varying fastest, i.e. in FAB (Fortran) order
+            buffer.resize(bx.numPts());
+            ncvar.get(buffer.data(), start, count);
 
-            int tot_size = shape_data[0]*shape_data[1]*shape_data[2]*shape_data[3];
-            // amrex::Print() << "Total points in the box constructed from netCDF variable: " << tot_size << std::endl;
+            FArrayBox host_fab(bx, 1, The_Pinned_Arena());
+            ConvertNCDataToFAB(buffer.data(), bx, host_fab, 0);
 
-            amrex::IntVect boxType{0, 0, 0};
-            amrex::Box bx = amrex::Box(smallEnd, bigEnd, boxType);
-            // amrex::Print() << "BX OF INPUT DATA " << bx << std::endl;
-
-            //auto num_pts = bdy_data_xlo[0].box().numPts();
-            //int ncomp  = bdy_data_xlo[0].nComp();
-            long num_pts;
-            Real* data_ptr;
-            std::string last3 = nc_var_names[i].substr(nc_var_names[i].size()-3, 3);
-
-            for (int nt(0); nt < ntimes; ++nt) {
-              if (last3 == "BXS") {
-                  num_pts = bdy_data_xlo[0].box().numPts();
-                  data_ptr = bdy_data_xlo[nt].dataPtr();
-              } else if (last3 == "BXE") {
-                  num_pts = bdy_data_xhi[0].box().numPts();
-                  data_ptr = bdy_data_xhi[nt].dataPtr();
-              } else if (last3 == "BYS") {
-                  num_pts = bdy_data_ylo[0].box().numPts();
-                  data_ptr = bdy_data_ylo[nt].dataPtr();
-              } else if (last3 == "BYE") {
-                  num_pts = bdy_data_yhi[0].box().numPts();
-                  data_ptr = bdy_data_yhi[nt].dataPtr();
-              }
-
-              //
-              // Here we put the components into the array in the order they are read
-              //
-              int k = i;
-              auto dataPtr = bdy_data_xlo[nt].dataPtr(k);
-              for (int n(0); n < num_pts; ++n) {
-                  *(dataPtr+n) = static_cast<Real>(*(arrays[i].get_data()+n));
-              }
-            } // nt
-        } //nc_var_names
-    } // if IOProcessor
-    return ntimes;
+            fab.template copy<RunOn::Device>(host_fab, bx, 0, bx, 0, 1);
+            Gpu::streamSynchronize();
+
+            read_boxes[i][n] = bx;
+        }
+    }
+    ncf.close();
 }
@@ -7,6 +7,9 @@ using namespace amrex;
 void
 ERF::WriteNCCheckpointFile () const
 {
+    // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+    if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
     // checkpoint file name, e.g., chk00010
     const std::string& checkpointname = amrex::Concatenate(check_file,istep[0],5);
 
@@ -121,6 +124,9 @@ ERF::WriteNCCheckpointFile () const
 void
 ERF::ReadNCCheckpointFile ()
 {
+    // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+    if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
     amrex::Print() << "Restart from checkpoint " << restart_chkfile << "\n";
 
     // Header
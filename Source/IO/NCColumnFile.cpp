@@ -1,3 +1,6 @@
+#include <set>
+
+#include "AMReX_Utility.H"
 #include "ERF.H"
 #include "NCInterface.H"
 #include "IndexDefines.H"
@@ -49,20 +52,18 @@ ERF::writeToNCColumnFile(const int lev,
                          const std::string& colfile_name, const Real xloc, const Real yloc,
                          const Real cumtime)
 {
+  // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+  if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
   //
   // This routine assumes that we can grab the whole column of data from the MultiFabs at
   //     a single level, "lev".  This assumption is true as long as we don't refine only
   //     partway up a column, which is the plan.
   //
 
-  // All processors: look for the requested column and get data if it's there
+  // Processors owning part of the requested column get its data there
   amrex::Box probBox = geom[lev].Domain();
   const size_t nheights = probBox.length(2) + 2;
-  amrex::Gpu::DeviceVector<Real> d_column_data(nheights*3, 0.0);
-  amrex::Vector<Real> h_column_data(nheights*3, 0.0);
-  Real* ucol = &d_column_data[0];
-  Real* vcol = &d_column_data[nheights];
-  Real* thetacol = &d_column_data[nheights*2];
 
   // Requested point must be inside problem domain
   if (xloc < geom[0].ProbLo(0) || xloc > geom[0].ProbHi(0) ||
@@ -102,22 +103,18 @@ ERF::writeToNCColumnFile(const int lev,
   const amrex::Box target_box(IntVect{iloc, jloc, kstart},
                               IntVect{iloc+1, jloc+1, kend});
 
-  //  Need data in one grow cell for interpolation
-  FillPatch(lev, t_new[lev], vars_new[lev]);
-
-  MultiFab& S_new = vars_new[lev][Vars::cons];
-  MultiFab& U_new = vars_new[lev][Vars::xvel];
-  MultiFab& V_new = vars_new[lev][Vars::yvel];
-
-  // No tiling - we're just interested in one location
-  for ( MFIter mfi(S_new); mfi.isValid(); ++mfi){
-    const amrex::Array4<Real const> & state = S_new.array(mfi);
-    const amrex::Array4<Real const> & velx  = U_new.array(mfi);
-    const amrex::Array4<Real const> & vely  = V_new.array(mfi);
+  // We include the ghost cells at physical boundaries for interpolation (i,j) or
+  //     saving (k); with a single level these (and the periodic ghost cells) were filled
+  //     by the final FillIntermediatePatch of the last advance. With more levels the
+  //     average down and reflux in post_timestep change the valid data after that fill,
+  //     so we need to fill the ghost cells again.
+  //     Every other point of the stencil is in the valid region of exactly one grid.
+  if (finest_level > 0) {
+    FillPatch(lev, t_new[lev], vars_new[lev]);
+  }
 
-    // we want to include data at physical boundary ghost cells
-    // for interpolation (i,j) or saving (k)
-    amrex::Box vbox = mfi.validbox();
+  auto column_vbox = [&] (amrex::Box vbox)
+  {
     for (int idir = 0; idir <=2; idir++) {
       if (vbox.smallEnd(idir) == probBox.smallEnd(idir)) {
         vbox.growLo(idir,1);
@@ -126,10 +123,44 @@ ERF::writeToNCColumnFile(const int lev,
         vbox.growHi(idir,1);
       }
     }
+    return vbox;
+  };
+
+  MultiFab& S_new = vars_new[lev][Vars::cons];
+  MultiFab& U_new = vars_new[lev][Vars::xvel];
+  MultiFab& V_new = vars_new[lev][Vars::yvel];
+
+  // Only the ranks owning grids that hold part of the stencil take part
+  const amrex::BoxArray& ba = S_new.boxArray();
+  const amrex::DistributionMapping& dm = S_new.DistributionMap();
+  std::set<int> owners;
+  for (const auto& is : ba.intersections(amrex::grow(target_box,1))) {
+    if ((column_vbox(ba[is.first]) & target_box).ok()) owners.insert(dm[is.first]);
+  }
+
+  const int myproc = amrex::ParallelDescriptor::MyProc();
+  const int ioproc = amrex::ParallelDescriptor::IOProcessorNumber();
+  const int tag    = amrex::ParallelDescriptor::SeqNum();
+
+  amrex::Vector<Real> h_column_data(nheights*3, 0.0);
+
+  if (owners.count(myproc))
+  {
+    amrex::Gpu::DeviceVector<Real> d_column_data(nheights*3, 0.0);
+    Real* ucol = &d_column_data[0];
+    Real* vcol = &d_column_data[nheights];
+    Real* thetacol = &d_column_data[nheights*2];
+
+    // No tiling - we're just interested in one location
+    for ( MFIter mfi(S_new); mfi.isValid(); ++mfi){
+      // Loop over indices where our box contains data needed for interpolation
+      const amrex::Box overlap_box = column_vbox(mfi.validbox()) & target_box;
+      if (!overlap_box.ok()) continue;
+
+      const amrex::Array4<Real const> & state = S_new.const_array(mfi);
+      const amrex::Array4<Real const> & velx  = U_new.const_array(mfi);
+      const amrex::Array4<Real const> & vely  = V_new.const_array(mfi);
 
-    // Loop over indices where our box contains data needed for interpolation
-    const amrex::Box overlap_box = vbox & target_box;
-    if (overlap_box.ok()) {
       amrex::ParallelFor(overlap_box,
       [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
         const int idx_vec = k - kstart;
@@ -141,35 +172,89 @@ ERF::writeToNCColumnFile(const int lev,
           * alpha_theta(ialpha, jalpha);
       });
     }
-  }
 
-  // Communicate values to CPU then to the IO processor
-  amrex::Gpu::copy(amrex::Gpu::deviceToHost, d_column_data.begin(),
-    d_column_data.end(), h_column_data.begin());
-  amrex::ParallelDescriptor::ReduceRealSum(h_column_data.data(),
-    h_column_data.size(), amrex::ParallelDescriptor::IOProcessorNumber());
+    amrex::Gpu::copy(amrex::Gpu::deviceToHost, d_column_data.begin(),
+      d_column_data.end(), h_column_data.begin());
 
-  // IO processor only: write the relevant data to file
+    // Send our part of the column to the IO processor
+    if (myproc != ioproc) {
+      amrex::ParallelDescriptor::Send(h_column_data.data(), h_column_data.size(), ioproc, tag);
+    }
+  }
+
+  // IO processor only: collect the column and add it to the buffered records
   if (amrex::ParallelDescriptor::IOProcessor()) {
-    auto ncf = ncutils::NCFile::open(colfile_name, NC_WRITE | NC_NETCDF4);
-    size_t putloc = ncf.dim("ntime").len();
-
-    // Time
-    amrex::Vector<size_t> start_t {putloc};
-    amrex::Vector<size_t> count_t {1};
-    ncf.var("times").put(&cumtime, start_t, count_t);
-
-    // T flux
-    // TODO: Make this the actual flux rather than just a placeholder
-    Real Tflux = 0.0;
-    ncf.var("wrf_tflux").put(&Tflux, start_t, count_t);
-
-    // U, V, Theta
-    std::vector<size_t> start = {putloc, 0};
-    std::vector<size_t> count = {1, nheights};
-    ncf.var("wrf_momentum_u").put(&h_column_data[0], start, count);
-    ncf.var("wrf_momentum_v").put(&h_column_data[nheights], start, count);
-    ncf.var("wrf_temperature").put(&h_column_data[2*nheights], start, count);
-    ncf.close();
+    amrex::Vector<Real> recv_data(nheights*3);
+    for (int proc : owners) {
+      if (proc == ioproc) continue;
+      amrex::ParallelDescriptor::Recv(recv_data.data(), recv_data.size(), proc, tag);
+      for (size_t n = 0; n < recv_data.size(); ++n) {
+        h_column_data[n] += recv_data[n];
+      }
+    }
+
+    if (!m_column_ncf) {
+      // Keep appending to an existing file when restarting
+      if (restart_chkfile == "" || !amrex::FileExists(colfile_name)) {
+        createNCColumnFile(lev, colfile_name, xloc, yloc);
+      }
+      m_column_ncf = std::make_unique<ncutils::NCFile>(
+        ncutils::NCFile::open(colfile_name, NC_WRITE | NC_NETCDF4));
+    }
+
+    m_column_buf.push_back(cumtime);
+    m_column_buf.insert(m_column_buf.end(), h_column_data.begin(), h_column_data.end());
+    ++m_column_nbuf;
+
+    if (m_column_nbuf >= column_buffer_size) {
+      flushNCColumnFile();
+    }
   }
 }
+
+void
+ERF::flushNCColumnFile()
+{
+  if (!m_column_ncf || m_column_nbuf == 0) return;
+
+  if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
+  auto& ncf = *m_column_ncf;
+  const size_t nheights = ncf.dim("nheight").len();
+  const size_t nrec = m_column_nbuf;
+  const size_t putloc = ncf.dim("ntime").len();
+
+  // Each buffered record holds the time followed by the u, v and theta columns
+  amrex::Vector<Real> times(nrec);
+  amrex::Vector<Real> Tflux(nrec, 0.0);
+  amrex::Vector<Real> u(nrec*nheights), v(nrec*nheights), theta(nrec*nheights);
+  for (size_t r = 0; r < nrec; ++r) {
+    const Real* rec = &m_column_buf[r*(1+3*nheights)];
+    times[r] = rec[0];
+    for (size_t k = 0; k < nheights; ++k) {
+      u    [r*nheights+k] = rec[1           +k];
+      v    [r*nheights+k] = rec[1+  nheights+k];
+      theta[r*nheights+k] = rec[1+2*nheights+k];
+    }
+  }
+
+  // Time
+  std::vector<size_t> start_t {putloc};
+  std::vector<size_t> count_t {nrec};
+  ncf.var("times").put(times.data(), start_t, count_t);
+
+  // T flux
+  // TODO: Make this the actual flux rather than just a placeholder
+  ncf.var("wrf_tflux").put(Tflux.data(), start_t, count_t);
+
+  // U, V, Theta
+  std::vector<size_t> start = {putloc, 0};
+  std::vector<size_t> count = {nrec, nheights};
+  ncf.var("wrf_momentum_u").put(u.data(), start, count);
+  ncf.var("wrf_momentum_v").put(v.data(), start, count);
+  ncf.var("wrf_temperature").put(theta.data(), start, count);
+  ncf.sync();
+
+  m_column_buf.clear();
+  m_column_nbuf = 0;
+}
@@ -243,6 +243,15 @@ void NCVar::get(
             ncid, varid, start.data(), count.data(), stride.data(), dptr));
 }
 
+void NCVar::get(
+        char* dptr,
+        const std::vector<size_t>& start,
+        const std::vector<size_t>& count) const
+{
+    check_nc_error(
+            nc_get_vara_text(ncid, varid, start.data(), count.data(), dptr));
+}
+
 bool NCVar::has_attr(const std::string& name) const
 {
     int ierr;
@@ -607,4 +616,9 @@ void NCFile::close()
     is_open = false;
     check_nc_error(nc_close(ncid));
 }
+
+void NCFile::sync() const
+{
+    check_nc_error(nc_sync(ncid));
+}
 } // namespace ncutils
@@ -25,6 +25,9 @@ ERF::ReadNCMultiFab(FabArray<FArrayBox> &mf,
                     int /*coordinatorProc*/,
                     int /*allow_empty_mf*/) {
 
+    // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+    if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
     const std::string& FullPath = amrex::Concatenate(check_file,istep[0],5);
 
     amrex::Print() << "Reading MultiFab NetCDF checkpoint file to path: " << FullPath << "\n";
@@ -84,6 +87,9 @@ ERF::WriteNCMultiFab (const FabArray<FArrayBox> &fab,
                       const std::string& name,
                       bool /*set_ghost*/) const {
 
+    // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+    if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
     if (amrex::ParallelDescriptor::IOProcessor())
     {
       static const std::string Suffix{"_Data.nc"};
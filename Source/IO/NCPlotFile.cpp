@@ -27,6 +27,9 @@ ERF::writeNCPlotFile(const std::string& dir, const Vector<const MultiFab*> &plot
                      const Vector<std::string> &plot_var_names,
                      const Vector<int> level_steps, const Real time) const
 {
+  // The NetCDF library is not thread safe, so let any background read of the wrfbdy file finish first
+  if (m_wrfbdy) m_wrfbdy->wait_for_prefetch();
+
   //
   // TODO: Right now this appears to be hard-wired for single-level so we'll leave it that way
   //
@@ -131,6 +131,69 @@ ERF::setPlotVariables ()
     }
 
     plot_deriv_names = tmp_deriv_names;
+
+    // Which of the plot variables should be written in 32-bit precision
+    // (checkpoint files are always written in full precision)
+    plot_float32_names.clear();
+    if (pp.contains("plot_float32_vars"))
+    {
+        const Vector<std::string> all_plot_names = PlotFileVarNames();
+
+        std::string nm;
+
+        int nFloatVars = pp.countval("plot_float32_vars");
+
+        for (int i = 0; i < nFloatVars; i++)
+        {
+            pp.get("plot_float32_vars", nm, i);
+
+            if (nm == "ALL") {
+                plot_float32_names = all_plot_names;
+            } else if (nm == "NONE" || nm == "None") {
+                plot_float32_names.clear();
+            } else if (!containerHasElement(all_plot_names, nm)) {
+                Warning("\nWARNING: Requested 32-bit output of variable '" + nm + "' but it is not being plotted");
+            } else if (!containerHasElement(plot_float32_names, nm)) {
+                plot_float32_names.push_back(nm);
+            }
+        }
+    }
+
+    // The native plotfile stores all components of a level in a single MultiFab, so the
+    //     precision is chosen for the whole file: we write 32-bit data only if every plotted
+    //     variable has been requested in 32-bit.  NetCDF plotfiles are always 32-bit and
+    //     compressed plotfiles have their own error bounds, so neither looks at this.
+    plot_native_float32 = !plot_float32_names.empty();
+    for (const auto& nm : PlotFileVarNames()) {
+        if (!containerHasElement(plot_float32_names, nm)) plot_native_float32 = false;
+    }
+    if (!plot_float32_names.empty() && !plot_native_float32 && plotfile_type == "amrex") {
+        Warning("\nWARNING: Native plotfiles are only written in 32-bit if all plot variables are in plot_float32_vars");
+    }
+    if (!plot_float32_names.empty() && plotfile_type != "amrex") {
+        Warning("\nWARNING: plot_float32_vars only applies to native plotfiles");
+    }
+
+    // Error tolerances for compressed plotfiles: a default relative (to the range of the variable)
+    //     or absolute tolerance, which may be overridden per variable; absolute takes precedence
+    plot_compress_tols.clear();
+    if (plotfile_type == "compressed")
+    {
+        PlotCompress::Tolerance default_tol;
+        pp.query("compress_rel_tol", default_tol.tol);
+        if (pp.query("compress_abs_tol", default_tol.tol)) default_tol.relative = false;
+        pp.query("compress_verify", plot_compress_verify);
+
+        for (const auto& nm : PlotFileVarNames()) {
+            PlotCompress::Tolerance tol = default_tol;
+            if (pp.query(("compress_rel_tol_"+nm).c_str(), tol.tol)) tol.relative = true;
+            if (pp.query(("compress_abs_tol_"+nm).c_str(), tol.tol)) tol.relative = false;
+            if (tol.tol < 0.0) {
+                Abort("Compression tolerance for plot variable " + nm + " must be non-negative");
+            }
+            plot_compress_tols.push_back(tol);
+        }
+    }
 }
 
 // set plotfile variable names
@@ -223,8 +286,10 @@ ERF::WritePlotFile ()
         calculate_derived("soundspeed",  derived::erf_dersoundspeed);
         calculate_derived("temp",        derived::erf_dertemp);
         calculate_derived("theta",       derived::erf_dertheta);
+#ifndef ERF_NO_TKE
         calculate_derived("KE",          derived::erf_derKE);
         calculate_derived("QKE",         derived::erf_derQKE);
+#endif
         calculate_derived("scalar",      derived::erf_derscalar);
 
         if (containerHasElement(plot_deriv_names, "pres_hse"))
@@ -535,6 +600,12 @@ ERF::WritePlotFile ()
     const std::string& plotfilename = PlotFileName(istep[0]);
     amrex::Print() << "Writing plotfile " << plotfilename << "\n";
 
+    // Checkpoint files use the same FAB format, so we only change it for the plotfile
+    const FABio::Format saved_fab_format = FArrayBox::getFormat();
+    if (plotfile_type == "amrex" && plot_native_float32) {
+        FArrayBox::setFormat(FABio::FAB_NATIVE_32);
+    }
+
     if (finest_level == 0)
     {
         if (plotfile_type == "amrex") {
@@ -562,6 +633,13 @@ ERF::WritePlotFile ()
                                            Geom(), t_new[0], istep, refRatio());
 #endif
             writeJobInfo(plotfilename);
+        } else if (plotfile_type == "compressed") {
+            PlotCompress::WriteCompressedPlotfile(plotfilename, finest_level+1, GetVecOfConstPtrs(mf),
+                                                  varnames, plot_compress_tols,
+                                                  Geom(), t_new[0], istep, refRatio());
+            if (plot_compress_verify) {
+                PlotCompress::VerifyCompressedPlotfile(plotfilename, finest_level+1, GetVecOfConstPtrs(mf));
+            }
 #ifdef ERF_USE_NETCDF
         } else {
              writeNCPlotFile(plotfilename, GetVecOfConstPtrs(mf), varnames, istep, t_new[0]);
@@ -619,12 +697,22 @@ ERF::WritePlotFile ()
             WriteMultiLevelPlotfile(plotfilename, finest_level+1, GetVecOfConstPtrs(mf2), varnames,
                                            g2, t_new[0], istep, rr);
             writeJobInfo(plotfilename);
+        } else if (plotfile_type == "compressed") {
+            PlotCompress::WriteCompressedPlotfile(plotfilename, finest_level+1, GetVecOfConstPtrs(mf2),
+                                                  varnames, plot_compress_tols,
+                                                  g2, t_new[0], istep, rr);
+            if (plot_compress_verify) {
+                PlotCompress::VerifyCompressedPlotfile(plotfilename, finest_level+1, GetVecOfConstPtrs(mf2));
+            }
 #ifdef ERF_USE_NETCDF
         } else {
              writeNCPlotFile(plotfilename, GetVecOfConstPtrs(mf2), varnames, istep, t_new[0]);
 #endif
         }
     } // end multi-level
+
+    // Restore the format so that checkpoint files are written in full precision
+    FArrayBox::setFormat(saved_fab_format);
 }
 
 #ifdef ERF_USE_TERRAIN
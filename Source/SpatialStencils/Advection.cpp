@@ -496,9 +496,11 @@ AdvectionSrcForState(const Box& bx, const int &icomp, const int &ncomp,
 
     for (int n = icomp; n < icomp+ncomp; n++)
     {
+#ifndef ERF_NO_TKE
         if ((n != RhoKE_comp && n != RhoQKE_comp) ||
             (  use_deardorff && n == RhoKE_comp) ||
             (  use_QKE       && n == RhoQKE_comp) )
+#endif
         {
             Real xflux_hi_n, xflux_lo_n, yflux_hi_n, yflux_lo_n, zflux_hi_n, zflux_lo_n;
             if (n != Rho_comp)
@@ -521,12 +523,14 @@ AdvectionSrcForState(const Box& bx, const int &icomp, const int &ncomp,
                 zflux_hi_n = zflux_hi; zflux_lo_n = zflux_lo;
             }
 
-            xflux(i+1,j,k,n) = xflux_hi_n;
-            xflux(i  ,j,k,n) = xflux_lo_n;
-            yflux(i,j+1,k,n) = yflux_hi_n;
-            yflux(i,j  ,k,n) = yflux_lo_n;
-            zflux(i,j,k+1,n) = zflux_hi_n;
-            zflux(i,j,k  ,n) = zflux_lo_n;
+            if (n < xflux.ncomp) {
+                xflux(i+1,j,k,n) = xflux_hi_n;
+                xflux(i  ,j,k,n) = xflux_lo_n;
+                yflux(i,j+1,k,n) = yflux_hi_n;
+                yflux(i,j  ,k,n) = yflux_lo_n;
+                zflux(i,j,k+1,n) = zflux_hi_n;
+                zflux(i,j,k  ,n) = zflux_lo_n;
+            }
 
             advectionSrc(i,j,k,n) = -( (xflux_hi_n - xflux_lo_n) * dxInv
                                       +(yflux_hi_n - yflux_lo_n) * dyInv
@@ -536,12 +540,14 @@ AdvectionSrcForState(const Box& bx, const int &icomp, const int &ncomp,
 #endif
         } else {
 
-            xflux(i+1,j,k,n) = 0.;
-            xflux(i  ,j,k,n) = 0.;
-            yflux(i,j+1,k,n) = 0.;
-            yflux(i,j  ,k,n) = 0.;
-            zflux(i,j,k+1,n) = 0.;
-            zflux(i,j,k  ,n) = 0.;
+            if (n < xflux.ncomp) {
+                xflux(i+1,j,k,n) = 0.;
+                xflux(i  ,j,k,n) = 0.;
+                yflux(i,j+1,k,n) = 0.;
+                yflux(i,j  ,k,n) = 0.;
+                zflux(i,j,k+1,n) = 0.;
+                zflux(i,j,k  ,n) = 0.;
+            }
 
             advectionSrc(i,j,k,n) = 0.;
         }
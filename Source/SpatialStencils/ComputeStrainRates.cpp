@@ -0,0 +1,80 @@
+/**
+ * \file ComputeStrainRates.cpp
+ */
+#include <AMReX.H>
+#include <AMReX_MultiFab.H>
+#include <SpatialStencils.H>
+#include <StrainRate.H>
+
+using namespace amrex;
+
+#ifndef ERF_USE_TERRAIN
+/**
+ * Evaluate the strain rate tensor and the expansion rate once so that the eddy viscosity,
+ * the momentum diffusion and the TKE production can all read them rather than each
+ * re-applying the velocity gradient stencils.
+ *
+ * The diagonal components and the expansion rate are stored at cell centers and the
+ * off-diagonal components on the edges where they are naturally defined; all of them
+ * are filled in the valid region and the ghost cells of the strain MultiFabs.
+ */
+void ComputeStrainRates(const MultiFab& xvel, const MultiFab& yvel, const MultiFab& zvel,
+                        Vector<MultiFab>& strain,
+                        const Geometry& geom,
+                        const Gpu::DeviceVector<BCRec>& domain_bcs_type_d)
+{
+    BL_PROFILE_VAR("ComputeStrainRates()",ComputeStrainRates);
+
+    const GpuArray<Real, AMREX_SPACEDIM> cellSizeInv = geom.InvCellSizeArray();
+    const Box& domain = geom.Domain();
+    const BCRec* bc_ptr = domain_bcs_type_d.data();
+
+    MultiFab& s_cc = strain[Strain::cc];
+    const IntVect ngrow = s_cc.nGrowVect();
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(s_cc,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& gbx  = mfi.growntilebox(ngrow);
+        const Box& gbxy = mfi.tilebox(IntVect(1,1,0),ngrow);
+        const Box& gbxz = mfi.tilebox(IntVect(1,0,1),ngrow);
+        const Box& gbyz = mfi.tilebox(IntVect(0,1,1),ngrow);
+
+        const Array4<Real const>& u = xvel.const_array(mfi);
+        const Array4<Real const>& v = yvel.const_array(mfi);
+        const Array4<Real const>& w = zvel.const_array(mfi);
+
+        const Array4<Real>& S   = s_cc.array(mfi);
+        const Array4<Real>& S12 = strain[Strain::xy].array(mfi);
+        const Array4<Real>& S13 = strain[Strain::xz].array(mfi);
+        const Array4<Real>& S23 = strain[Strain::yz].array(mfi);
+
+        amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            Real s11 = ComputeS11(i+1, j, k, u, cellSizeInv);
+            Real s22 = ComputeS22(i, j+1, k, v, cellSizeInv);
+            Real s33 = ComputeS33(i, j, k+1, w, cellSizeInv);
+            S(i,j,k,Strain::S11) = s11;
+            S(i,j,k,Strain::S22) = s22;
+            S(i,j,k,Strain::S33) = s33;
+            S(i,j,k,Strain::Expansion) = (1.0/3.0) * (s11 + s22 + s33);
+        });
+
+        amrex::ParallelFor(gbxy, gbxz, gbyz,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            S12(i,j,k) = ComputeS12(i, j, k, u, v, w, cellSizeInv, domain, bc_ptr);
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            S13(i,j,k) = ComputeS13(i, j, k, u, v, w, cellSizeInv, domain, bc_ptr);
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        {
+            S23(i,j,k) = ComputeS23(i, j, k, u, v, w, cellSizeInv, domain, bc_ptr);
+        });
+    }
+}
+#endif
@@ -6,13 +6,50 @@
 
 using namespace amrex;
 
-/** Compute Eddy Viscosity */
+/** Set all the LES diffusivities in cell (i,j,k) given the eddy viscosity K = 2 mu_t */
+AMREX_GPU_DEVICE AMREX_FORCE_INLINE
+void SetLESDiffusivities(int i, int j, int k,
+                         const amrex::Array4<amrex::Real>& K, amrex::Real mu_turb,
+                         amrex::Real inv_Pr_t, amrex::Real inv_Sc_t, amrex::Real inv_sigma_k,
+                         bool use_KE, bool use_QKE_3D) noexcept
+{
+    // Get eddy diffusivities from the eddy viscosity
+    // Additional factor of 0.5 because K = 2 mu_t
+    amrex::Real K_theta  = 0.5 * mu_turb * inv_Pr_t;
+    amrex::Real K_scalar = 0.5 * mu_turb * inv_Sc_t;
+    amrex::Real K_KE     = use_KE     ? 0.5 * mu_turb * inv_sigma_k : 0.0;
+    amrex::Real K_QKE    = use_QKE_3D ? 0.5 * mu_turb * inv_sigma_k : 0.0;
+
+    // For LES: vertical and horizontal components are the same
+    K(i,j,k,EddyDiff::Mom_h)    = mu_turb;
+    K(i,j,k,EddyDiff::Mom_v)    = mu_turb;
+    K(i,j,k,EddyDiff::Theta_h)  = K_theta;
+    K(i,j,k,EddyDiff::Theta_v)  = K_theta;
+    K(i,j,k,EddyDiff::Scalar_h) = K_scalar;
+    K(i,j,k,EddyDiff::Scalar_v) = K_scalar;
+    K(i,j,k,EddyDiff::KE_h)     = K_KE;
+    K(i,j,k,EddyDiff::KE_v)     = K_KE;
+
+    // QKE: vertical diffusion (and the length scale) come from the PBL model
+    K(i,j,k,EddyDiff::QKE_h)    = K_QKE;
+    K(i,j,k,EddyDiff::QKE_v)    = 0.0;
+    K(i,j,k,EddyDiff::PBL_lengthscale) = 0.0;
+}
+
+/** Compute Eddy Viscosity
+ *
+ *  All the components are set in a single pass over the grown tile boxes. Ghost cells
+ *  outside the domain in a non-periodic direction take the value of the nearest cell
+ *  inside, which we get by evaluating the model there directly rather than copying it
+ *  in further passes.
+ */
 void ComputeTurbulentViscosityLES(const amrex::MultiFab& xvel, const amrex::MultiFab& yvel, const amrex::MultiFab& zvel,
                                   const amrex::MultiFab& cons_in, amrex::MultiFab& eddyViscosity,
                                   const amrex::Geometry& geom,
                                   const SolverChoice& solverChoice,
                                   const amrex::Gpu::DeviceVector<amrex::BCRec> domain_bcs_type_d,
-                                  bool vert_only)
+                                  bool vert_only,
+                                  const amrex::Vector<amrex::MultiFab>* strain)
 {
     const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> cellSizeInv = geom.InvCellSizeArray();
 
@@ -20,177 +57,107 @@ void ComputeTurbulentViscosityLES(const amrex::MultiFab& xvel, const amrex::Mult
     const amrex::Real Delta = std::pow(cellVol,1.0/3.0);
 
     const auto& domain = geom.Domain();
-    const auto& dom_lo = amrex::lbound(domain);
-    const auto& dom_hi = amrex::ubound(domain);
-
-    const int klo = dom_lo.z;
-
-    // We must initialize all the components to 0 because we may not set all of them below
-    //    (which ones depends on which LES / PBL scheme we are using)
-    eddyViscosity.setVal(0.0);
-
-    bool l_vert_only = vert_only;
-
-    // Compute the turbulent viscosity
-    if (solverChoice.les_type == LESType::Smagorinsky)
-    {
-      amrex::Real Cs = solverChoice.Cs;
-      amrex::Real CsDeltaSqr = Cs*Cs*Delta*Delta;
 
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-      for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const int klo = domain.smallEnd(2);
 
-        amrex::Box bx = mfi.growntilebox(1);
-        if (l_vert_only)
-            bx.setRange(2,klo,1);
-
-        const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
-        const amrex::Array4<amrex::Real> &K = eddyViscosity.array(mfi);
-
-        const amrex::Array4<amrex::Real const> &u = xvel.array(mfi);
-        const amrex::Array4<amrex::Real const> &v = yvel.array(mfi);
-        const amrex::Array4<amrex::Real const> &w = zvel.array(mfi);
+    // Range the cell indices are clamped to: the domain, except in periodic directions
+    amrex::Box clamp_box(domain);
+    for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
+        if (geom.isPeriodic(dir)) clamp_box.grow(dir, eddyViscosity.nGrow());
+    }
+    const auto clo = amrex::lbound(clamp_box);
+    const auto chi = amrex::ubound(clamp_box);
 
-        const amrex::BCRec* bc_ptr = domain_bcs_type_d.data();
+    const amrex::Real inv_Pr_t    = solverChoice.Pr_t_inv;
+    const amrex::Real inv_Sc_t    = solverChoice.Sc_t_inv;
+    const amrex::Real inv_sigma_k = 1.0 / solverChoice.sigma_k;
+    const bool use_KE     = (solverChoice.les_type == LESType::Deardorff);
+    const bool use_QKE_3D = (solverChoice.use_QKE && solverChoice.diffuse_QKE_3D);
 
-        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
-        {
-            amrex::Real SmnSmn = ComputeSmnSmn(i,j,k,u,v,w,cellSizeInv,domain,bc_ptr);
+    const amrex::Real CsDeltaSqr = solverChoice.Cs * solverChoice.Cs * Delta * Delta;
+    const amrex::Real l_C_k      = solverChoice.Ck;
 
-            // Note the positive sign, which aligns well with the positive sign in the diffusion term for momentum equation
-            K(i, j, k, EddyDiff::Mom_h) = 2.0 * CsDeltaSqr * cell_data(i, j, k, Rho_comp) * std::sqrt(2.0*SmnSmn);
-        });
-      } //mfi
-    }
-    else if (solverChoice.les_type == LESType::Deardorff)
-    {
-      amrex::Real l_C_k = solverChoice.Ck;
+    const bool use_strain = (strain != nullptr);
 
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-      for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
 
         amrex::Box bx = mfi.growntilebox(1);
-        if (l_vert_only)
-            bx.setRange(2,klo,1);
+        if (vert_only) {
+            // Only the bottom layer (and the ghost cells below it) are needed for MOST
+            bx.setSmall(2, amrex::max(bx.smallEnd(2), klo-1));
+            bx.setBig  (2, amrex::min(bx.bigEnd  (2), klo  ));
+            if (!bx.ok()) continue;
+        }
 
         const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
         const amrex::Array4<amrex::Real> &K = eddyViscosity.array(mfi);
 
-        amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+        if (solverChoice.les_type == LESType::Smagorinsky && use_strain)
         {
-            // K = rho * C_k * Delta * KE^(1/2) = C_k * Delta * (rho * RhoKE)^1/2
-            K(i,j,k,EddyDiff::Mom_h) = l_C_k * Delta *
-                                std::sqrt(cell_data(i,j,k,RhoKE_comp) * cell_data(i,j,k,Rho_comp));
-        });
-      } //mfi
-    }
+#ifndef ERF_USE_TERRAIN
+            const amrex::Array4<amrex::Real const> &s_cc = (*strain)[Strain::cc].const_array(mfi);
+            const amrex::Array4<amrex::Real const> &s12  = (*strain)[Strain::xy].const_array(mfi);
+            const amrex::Array4<amrex::Real const> &s13  = (*strain)[Strain::xz].const_array(mfi);
+            const amrex::Array4<amrex::Real const> &s23  = (*strain)[Strain::yz].const_array(mfi);
 
-    // Fill in the rest of the turbulent diffusivities
-    if (solverChoice.les_type == LESType::Smagorinsky ||
-        solverChoice.les_type == LESType::Deardorff)
-    {
-        amrex::Real inv_Pr_t = solverChoice.Pr_t_inv;
-        amrex::Real inv_Sc_t = solverChoice.Sc_t_inv;
-        amrex::Real inv_sigma_k = 1.0 / solverChoice.sigma_k;
-        bool use_KE = (solverChoice.les_type == LESType::Deardorff);
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                int ii = amrex::min(amrex::max(i, clo.x), chi.x);
+                int jj = amrex::min(amrex::max(j, clo.y), chi.y);
+                int kk = amrex::min(amrex::max(k, clo.z), chi.z);
 
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+                amrex::Real SmnSmn = ComputeSmnSmn(ii,jj,kk,s_cc,s12,s13,s23);
+                amrex::Real mu_turb = 2.0 * CsDeltaSqr * cell_data(ii, jj, kk, Rho_comp) * std::sqrt(2.0*SmnSmn);
+
+                SetLESDiffusivities(i, j, k, K, mu_turb, inv_Pr_t, inv_Sc_t, inv_sigma_k, use_KE, use_QKE_3D);
+            });
 #endif
-        for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi)
+        }
+        else if (solverChoice.les_type == LESType::Smagorinsky)
         {
-            amrex::Box bx = mfi.growntilebox(1);
-            if (l_vert_only)
-                bx.setRange(2,klo,1);
+            const amrex::Array4<amrex::Real const> &u = xvel.array(mfi);
+            const amrex::Array4<amrex::Real const> &v = yvel.array(mfi);
+            const amrex::Array4<amrex::Real const> &w = zvel.array(mfi);
 
-            const amrex::Array4<amrex::Real> &K = eddyViscosity.array(mfi);
+            const amrex::BCRec* bc_ptr = domain_bcs_type_d.data();
 
             amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
             {
-                // Get eddy diffusivities from the eddy viscosity
-                // Additional factor of 0.5 because K = 2 mu_t
-                K(i,j,k,EddyDiff::Theta_h) = 0.5 * K(i,j,k,EddyDiff::Mom_h) * inv_Pr_t;
-                K(i,j,k,EddyDiff::Scalar_h) = 0.5 * K(i,j,k,EddyDiff::Mom_h) * inv_Sc_t;
-                if (use_KE) {
-                    K(i,j,k,EddyDiff::KE_h) = 0.5 * K(i,j,k,EddyDiff::Mom_h) * inv_sigma_k;
-                }
-                if (solverChoice.use_QKE && solverChoice.diffuse_QKE_3D) {
-                    K(i,j,k,EddyDiff::QKE_h) = 0.5 * K(i,j,k,EddyDiff::Mom_h) * inv_sigma_k;
-                }
-
-                // For LES: vertical and horizontal components are the same
-                K(i,j,k,EddyDiff::Mom_v) = K(i,j,k,EddyDiff::Mom_h);
-                K(i,j,k,EddyDiff::Theta_v) = K(i,j,k,EddyDiff::Theta_h);
-                K(i,j,k,EddyDiff::Scalar_v) = K(i,j,k,EddyDiff::Scalar_h);
-                if (use_KE) {
-                    K(i,j,k,EddyDiff::KE_v) = K(i,j,k,EddyDiff::KE_h);
-                }
-                // QKE: vertical diffusion from PBL model
-            });
-        }
-    }
+                int ii = amrex::min(amrex::max(i, clo.x), chi.x);
+                int jj = amrex::min(amrex::max(j, clo.y), chi.y);
+                int kk = amrex::min(amrex::max(k, clo.z), chi.z);
 
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
-
-        const amrex::Box &bx = mfi.growntilebox(1);
-
-        if (!(domain.contains(bx))) {
-            // Fill values outside the domain by straightforward extrapolation.  Note this must be
-            // done separately from the loop above so all the interior values are filled.  We also
-            // do this in three separate loops so that we don't have any race conditions.
-            const amrex::Array4<amrex::Real> &K = eddyViscosity.array(mfi);
-            amrex::ParallelFor(bx, (int) EddyDiff::NumDiffs, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept {
-                if (i < dom_lo.x) {
-                    if (j < dom_lo.y)
-                        K(i,j,k,n) = K(dom_lo.x,dom_lo.y,k,n);
-                    else if (j > dom_hi.y)
-                        K(i,j,k,n) = K(dom_lo.x,dom_hi.y,k,n);
-                    else
-                       K(i,j,k,n) = K(dom_lo.x,j,k,n);
-                } else if (i > dom_hi.x) {
-                    if (j < dom_lo.y)
-                        K(i,j,k,n) = K(dom_hi.x,dom_lo.y,k,n);
-                    else if (j > dom_hi.y)
-                        K(i,j,k,n) = K(dom_hi.x,dom_hi.y,k,n);
-                    else
-                        K(i,j,k,n) = K(dom_hi.x,j,k,n);
-                } else if (j < dom_lo.y) {
-                        K(i,j,k,n) = K(i,dom_lo.y,k,n);
-                } else if (j > dom_hi.y) {
-                        K(i,j,k,n) = K(i,dom_hi.y,k,n);
-                }
-           });
-        }
-    } //mfi
+                amrex::Real SmnSmn = ComputeSmnSmn(ii,jj,kk,u,v,w,cellSizeInv,domain,bc_ptr);
 
-    // Fill interior ghost cells and any ghost cells outside a periodic domain
-    eddyViscosity.FillBoundary(geom.periodicity());
+                // Note the positive sign, which aligns well with the positive sign in the diffusion term for momentum equation
+                amrex::Real mu_turb = 2.0 * CsDeltaSqr * cell_data(ii, jj, kk, Rho_comp) * std::sqrt(2.0*SmnSmn);
 
-    // Now extend to low and high in vertical
-#ifdef _OPENMP
-#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
-#endif
-    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+                SetLESDiffusivities(i, j, k, K, mu_turb, inv_Pr_t, inv_Sc_t, inv_sigma_k, use_KE, use_QKE_3D);
+            });
+        }
+#ifndef ERF_NO_TKE
+        else if (solverChoice.les_type == LESType::Deardorff)
+        {
+            amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+            {
+                int ii = amrex::min(amrex::max(i, clo.x), chi.x);
+                int jj = amrex::min(amrex::max(j, clo.y), chi.y);
+                int kk = amrex::min(amrex::max(k, clo.z), chi.z);
 
-        const amrex::Box &bx = mfi.growntilebox(1);
+                // K = rho * C_k * Delta * KE^(1/2) = C_k * Delta * (rho * RhoKE)^1/2
+                amrex::Real mu_turb = l_C_k * Delta *
+                    std::sqrt(cell_data(ii,jj,kk,RhoKE_comp) * cell_data(ii,jj,kk,Rho_comp));
 
-        if (!(domain.contains(bx))) {
-            const amrex::Array4<amrex::Real> &K = eddyViscosity.array(mfi);
-            amrex::ParallelFor(bx, (int) EddyDiff::NumDiffs, [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
-            {
-                if (k < dom_lo.z) K(i,j,k,n) = K(i,j,dom_lo.z,n);
-                if (k > dom_hi.z) K(i,j,k,n) = K(i,j,dom_hi.z,n);
+                SetLESDiffusivities(i, j, k, K, mu_turb, inv_Pr_t, inv_Sc_t, inv_sigma_k, use_KE, use_QKE_3D);
             });
         }
+#endif
     } //mfi
 
+    // Fill interior ghost cells and any ghost cells outside a periodic domain
     eddyViscosity.FillBoundary(geom.periodicity());
 
 } // ComputeTurbulentViscosityLES
@@ -199,8 +166,10 @@ void ComputeTurbulentViscosity(const amrex::MultiFab& xvel, const amrex::MultiFa
                                const amrex::MultiFab& cons_in, amrex::MultiFab& eddyViscosity,
                                const amrex::Geometry& geom,
                                const SolverChoice& solverChoice, std::unique_ptr<ABLMost>& most,
+                               MYNNColumns* mynn_columns,
                                const amrex::Gpu::DeviceVector<amrex::BCRec> domain_bcs_type_d,
-                               bool vert_only)
+                               bool vert_only,
+                               const amrex::Vector<amrex::MultiFab>* strain)
 {
     //
     // In LES mode, the turbulent viscosity is isotropic, so the LES model sets both horizontal and vertical viscosities
@@ -211,7 +180,12 @@ void ComputeTurbulentViscosity(const amrex::MultiFab& xvel, const amrex::MultiFa
     // ComputeTurbulentViscosityLES populates the LES viscosity for both horizontal and vertical components.
     // ComputeTurbulentViscosityPBL computes the PBL viscosity just for the vertical component.
     //
-    eddyViscosity.setVal(0.0);
+    // The LES model sets every component over the whole grown box, so we only need to
+    //    initialize the data if it is not going to be called (or only for the bottom layer)
+    const bool les_sets_all = !vert_only &&
+                              ((solverChoice.les_type == LESType::Smagorinsky) ||
+                               (solverChoice.les_type == LESType::Deardorff  ));
+    if (!les_sets_all) eddyViscosity.setVal(0.0);
 
     if (most) {
         AMREX_ALWAYS_ASSERT_WITH_MESSAGE(solverChoice.les_type == LESType::Smagorinsky ||
@@ -230,11 +204,15 @@ void ComputeTurbulentViscosity(const amrex::MultiFab& xvel, const amrex::MultiFa
 
             ComputeTurbulentViscosityLES(xvel, yvel, zvel, cons_in, eddyViscosity,
                                          geom, solverChoice,
-                                         domain_bcs_type_d, vert_only);
+                                         domain_bcs_type_d, vert_only, strain);
     }
 
+#ifndef ERF_NO_TKE
     if (solverChoice.pbl_type != PBLType::None) {
             ComputeTurbulentViscosityPBL(xvel, yvel, cons_in, eddyViscosity,
-                                         geom, solverChoice, most, vert_only);
+                                         geom, solverChoice, most, mynn_columns, vert_only);
     }
+#else
+    amrex::ignore_unused(mynn_columns);
+#endif
 }
@@ -418,7 +418,10 @@ DiffusionSrcForMom(const int &i, const int &j, const int &k,
                             const GpuArray<Real, AMREX_SPACEDIM>& cellSizeInv,
                             const Array4<Real>& K_turb,
                             const SolverChoice &solverChoice,
-                            const Box& domain, const amrex::BCRec* bc_ptr)
+                            const Array4<const Real>& s_cc,
+                            const Array4<const Real>& s12,
+                            const Array4<const Real>& s13,
+                            const Array4<const Real>& s23)
 {
     auto dxInv = cellSizeInv[0], dyInv = cellSizeInv[1], dzInv = cellSizeInv[2];
     Real diffContrib = 0.0;
@@ -428,18 +431,18 @@ DiffusionSrcForMom(const int &i, const int &j, const int &k,
     switch (momentumEqn) {
         case MomentumEqn::x:
             Real tau11Next, tau11Prev, tau12Next, tau12Prev, tau13Next, tau13Prev;
-            tau11Next = ComputeStressTerm(i+1, j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau11Prev = ComputeStressTerm(i  , j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau12Next = ComputeStressTerm(i, j+1, k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau12Prev = ComputeStressTerm(i, j  , k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau13Next = ComputeStressTerm(i, j, k+1, u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau13Prev = ComputeStressTerm(i, j, k  , u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
+            tau11Next = ComputeStressTerm(i+1, j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau11Prev = ComputeStressTerm(i  , j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau12Next = ComputeStressTerm(i, j+1, k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau12Prev = ComputeStressTerm(i, j  , k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau13Next = ComputeStressTerm(i, j, k+1, momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau13Prev = ComputeStressTerm(i, j, k  , momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
 
             diffContrib = (tau11Next - tau11Prev) * dxInv  // Contribution to x-mom eqn from diffusive flux in x-dir
                         + (tau12Next - tau12Prev) * dyInv  // Contribution to x-mom eqn from diffusive flux in y-dir
@@ -452,18 +455,18 @@ DiffusionSrcForMom(const int &i, const int &j, const int &k,
             break;
         case MomentumEqn::y:
             Real tau21Next, tau21Prev, tau22Next, tau22Prev, tau23Next, tau23Prev;
-            tau21Next = ComputeStressTerm(i+1, j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau21Prev = ComputeStressTerm(i  , j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau22Next = ComputeStressTerm(i, j+1, k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau22Prev = ComputeStressTerm(i, j  , k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau23Next = ComputeStressTerm(i, j, k+1, u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau23Prev = ComputeStressTerm(i, j, k  , u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
+            tau21Next = ComputeStressTerm(i+1, j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau21Prev = ComputeStressTerm(i  , j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau22Next = ComputeStressTerm(i, j+1, k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau22Prev = ComputeStressTerm(i, j  , k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau23Next = ComputeStressTerm(i, j, k+1, momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau23Prev = ComputeStressTerm(i, j, k  , momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
 
             diffContrib = (tau21Next - tau21Prev) * dxInv  // Contribution to y-mom eqn from diffusive flux in x-dir
                         + (tau22Next - tau22Prev) * dyInv  // Contribution to y-mom eqn from diffusive flux in y-dir
@@ -476,18 +479,18 @@ DiffusionSrcForMom(const int &i, const int &j, const int &k,
             break;
         case MomentumEqn::z:
             Real tau31Next, tau31Prev, tau32Next, tau32Prev, tau33Next, tau33Prev;
-            tau31Next = ComputeStressTerm(i+1, j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau31Prev = ComputeStressTerm(i  , j, k, u, v, w, momentumEqn,
-                                          DiffusionDir::x, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau32Next = ComputeStressTerm(i, j+1, k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau32Prev = ComputeStressTerm(i, j  , k, u, v, w, momentumEqn,
-                                          DiffusionDir::y, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau33Next = ComputeStressTerm(i, j, k+1, u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
-            tau33Prev = ComputeStressTerm(i, j, k  , u, v, w, momentumEqn,
-                                          DiffusionDir::z, cellSizeInv, K_turb, solverChoice, domain, bc_ptr);
+            tau31Next = ComputeStressTerm(i+1, j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau31Prev = ComputeStressTerm(i  , j, k, momentumEqn, DiffusionDir::x,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau32Next = ComputeStressTerm(i, j+1, k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau32Prev = ComputeStressTerm(i, j  , k, momentumEqn, DiffusionDir::y,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau33Next = ComputeStressTerm(i, j, k+1, momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
+            tau33Prev = ComputeStressTerm(i, j, k  , momentumEqn, DiffusionDir::z,
+                                          s_cc, s12, s13, s23, K_turb, solverChoice);
 
             diffContrib = (tau31Next - tau31Prev) * dxInv  // Contribution to z-mom eqn from diffusive flux in x-dir
                         + (tau32Next - tau32Prev) * dyInv  // Contribution to z-mom eqn from diffusive flux in y-dir
@@ -546,6 +549,7 @@ amrex::Real ComputeDiffusionFluxForState(const int &i, const int &j, const int &
           }
           break;
 
+#ifndef ERF_NO_TKE
       case PrimKE_comp: // Turbulent KE
           rhoAlpha_molec = 0.;
           if (coordDir == Coord::z) {
@@ -563,6 +567,7 @@ amrex::Real ComputeDiffusionFluxForState(const int &i, const int &j, const int &
               eddy_diff_idx = EddyDiff::QKE_h;
           }
           break;
+#endif
 
       case PrimScalar_comp: // Scalar
           if (solverChoice.molec_diff_type == MolecDiffType::ConstantAlpha) {
@@ -617,19 +622,29 @@ DiffusionSrcForState(const int &i, const int &j, const int &k,
   const int prim_index = qty_index - RhoTheta_comp;
 
   // TODO : could be more efficient to compute and save all fluxes before taking divergence (now all fluxes are computed 2x);
-  xflux(i+1,j,k,qty_index) = ComputeDiffusionFluxForState(i+1, j, k, cell_data, cell_prim, prim_index, dx_inv, K_turb, solverChoice, Coord::x);
-  xflux(i  ,j,k,qty_index) = ComputeDiffusionFluxForState(i  , j, k, cell_data, cell_prim, prim_index, dx_inv, K_turb, solverChoice, Coord::x);
-
-  yflux(i,j+1,k,qty_index) = ComputeDiffusionFluxForState(i, j+1, k, cell_data, cell_prim, prim_index, dy_inv, K_turb, solverChoice, Coord::y);
-  yflux(i,j  ,k,qty_index) = ComputeDiffusionFluxForState(i, j  , k, cell_data, cell_prim, prim_index, dy_inv, K_turb, solverChoice, Coord::y);
-
-  zflux(i,j,k+1,qty_index) = ComputeDiffusionFluxForState(i, j, k+1, cell_data, cell_prim, prim_index, dz_inv, K_turb, solverChoice, Coord::z);
-  zflux(i,j,k  ,qty_index) = ComputeDiffusionFluxForState(i, j, k  , cell_data, cell_prim, prim_index, dz_inv, K_turb, solverChoice, Coord::z);
+  const Real xflux_hi = ComputeDiffusionFluxForState(i+1, j, k, cell_data, cell_prim, prim_index, dx_inv, K_turb, solverChoice, Coord::x);
+  const Real xflux_lo = ComputeDiffusionFluxForState(i  , j, k, cell_data, cell_prim, prim_index, dx_inv, K_turb, solverChoice, Coord::x);
+
+  const Real yflux_hi = ComputeDiffusionFluxForState(i, j+1, k, cell_data, cell_prim, prim_index, dy_inv, K_turb, solverChoice, Coord::y);
+  const Real yflux_lo = ComputeDiffusionFluxForState(i, j  , k, cell_data, cell_prim, prim_index, dy_inv, K_turb, solverChoice, Coord::y);
+
+  const Real zflux_hi = ComputeDiffusionFluxForState(i, j, k+1, cell_data, cell_prim, prim_index, dz_inv, K_turb, solverChoice, Coord::z);
+  const Real zflux_lo = ComputeDiffusionFluxForState(i, j, k  , cell_data, cell_prim, prim_index, dz_inv, K_turb, solverChoice, Coord::z);
+
+  // The fluxes are only stored when they are needed for refluxing
+  if (xflux) {
+      xflux(i+1,j,k,qty_index) = xflux_hi;
+      xflux(i  ,j,k,qty_index) = xflux_lo;
+      yflux(i,j+1,k,qty_index) = yflux_hi;
+      yflux(i,j  ,k,qty_index) = yflux_lo;
+      zflux(i,j,k+1,qty_index) = zflux_hi;
+      zflux(i,j,k  ,qty_index) = zflux_lo;
+  }
 
   Real diffusionSrc =
-      (xflux(i+1,j,k,qty_index) - xflux(i  ,j,k,qty_index)) * dx_inv   // Diffusive flux in x-dir
-     +(yflux(i,j+1,k,qty_index) - yflux(i,j  ,k,qty_index)) * dy_inv   // Diffusive flux in y-dir
-     +(zflux(i,j,k+1,qty_index) - zflux(i,j,k  ,qty_index)) * dz_inv;  // Diffusive flux in z-dir
+      (xflux_hi - xflux_lo) * dx_inv   // Diffusive flux in x-dir
+     +(yflux_hi - yflux_lo) * dy_inv   // Diffusive flux in y-dir
+     +(zflux_hi - zflux_lo) * dz_inv;  // Diffusive flux in z-dir
 
   return diffusionSrc;
 }
@@ -0,0 +1,236 @@
+/** \file PBLModels.cpp */
+
+#include <ABLMost.H>
+#include <PBLModels.H>
+
+using namespace amrex;
+
+MYNNColumns::MYNNColumns (const BoxArray& a_ba, const DistributionMapping& a_dm, const Geometry& geom)
+    : ba(a_ba), dm(a_dm)
+{
+    const Box& domain = geom.Domain();
+
+    // The xy footprint of each box, at the bottom of the domain
+    BoxList col_bl;
+    for (int i = 0; i < ba.size(); ++i) {
+        Box fb(ba[i]);
+        fb.setRange(2, domain.smallEnd(2));
+        col_bl.push_back(fb);
+    }
+    cols.define(BoxArray(std::move(col_bl)), dm, 2, IntVect(1,1,0));
+
+    // The xy footprint of the domain, including the ghost cells outside non-periodic boundaries
+    Box col_domain(domain);
+    col_domain.setRange(2, domain.smallEnd(2));
+    for (int dir = 0; dir < 2; ++dir) {
+        if (!geom.isPeriodic(dir)) col_domain.grow(dir, 1);
+    }
+    BoxArray total_ba(col_domain);
+    total_ba.maxSize(IntVect(AMREX_D_DECL(256,256,1)));
+    total.define(total_ba, DistributionMapping(total_ba), 2, 0);
+}
+
+#ifndef ERF_NO_TKE
+void ComputeTurbulentViscosityPBL(const amrex::MultiFab& xvel,
+                                  const amrex::MultiFab& yvel,
+                                  const amrex::MultiFab& cons_in,
+                                  amrex::MultiFab& eddyViscosity,
+                                  const amrex::Geometry& geom,
+                                  const SolverChoice& solverChoice,
+                                  std::unique_ptr<ABLMost>& most,
+                                  MYNNColumns* mynn_columns,
+                                  bool /*vert_only*/)
+{
+  // MYNN Level 2.5 PBL Model
+  if (solverChoice.pbl_type == PBLType::MYNN25) {
+
+    BL_PROFILE("ComputeTurbulentViscosityPBL()");
+
+    const amrex::Real A1 = solverChoice.pbl_A1;
+    const amrex::Real A2 = solverChoice.pbl_A2;
+    //const amrex::Real B1 = solverChoice.pbl_B1;
+    const amrex::Real B2 = solverChoice.pbl_B2;
+    const amrex::Real C1 = solverChoice.pbl_C1;
+    const amrex::Real C2 = solverChoice.pbl_C2;
+    const amrex::Real C3 = solverChoice.pbl_C3;
+    //const amrex::Real C4 = solverChoice.pbl_C4;
+    const amrex::Real C5 = solverChoice.pbl_C5;
+
+    const amrex::Box& dbx = geom.Domain();
+    const amrex::GeometryData gdata = geom.data();
+
+    // ************************************************************************************
+    // Column integrals of z*q and q over the interior of the domain in the vertical.
+    // Each box adds up the cells of its own columns one column per thread, and the parts
+    // from the boxes stacked in each column are then summed across boxes (and ranks) and
+    // copied back onto the footprint of each box.
+    // ************************************************************************************
+    AMREX_ALWAYS_ASSERT(mynn_columns != nullptr);
+    MultiFab& cols = mynn_columns->cols;
+    AMREX_ALWAYS_ASSERT(mynn_columns->ba == eddyViscosity.boxArray() &&
+                        mynn_columns->dm == eddyViscosity.DistributionMap());
+
+    cols.setVal(0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(cols,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+      // The columns we are responsible for: those of the tile, plus the ghost columns
+      //     outside non-periodic domain boundaries (which no other box covers)
+      amrex::Box cbx = mfi.tilebox();
+      const amrex::Box& vbx = mfi.validbox();
+      for (int dir = 0; dir < 2; ++dir) {
+          if (geom.isPeriodic(dir)) continue;
+          if (cbx.smallEnd(dir) == vbx.smallEnd(dir) && vbx.smallEnd(dir) == dbx.smallEnd(dir)) cbx.growLo(dir,1);
+          if (cbx.bigEnd(dir)   == vbx.bigEnd(dir)   && vbx.bigEnd(dir)   == dbx.bigEnd(dir))   cbx.growHi(dir,1);
+      }
+
+      // The part of the columns inside this box and the domain
+      const amrex::Box& gbx = eddyViscosity.boxArray()[mfi.index()];
+      const int klo = amrex::max(gbx.smallEnd(2), dbx.smallEnd(2));
+      const int khi = amrex::min(gbx.bigEnd(2)  , dbx.bigEnd(2));
+
+      const amrex::Array4<amrex::Real const> &cell_data = cons_in.array(mfi);
+      const amrex::Array4<amrex::Real> &qint = cols.array(mfi);
+
+      amrex::ParallelFor(cbx, [=] AMREX_GPU_DEVICE (int i, int j, int k0) noexcept
+      {
+          amrex::Real zq = 0.0;
+          amrex::Real q  = 0.0;
+          for (int k = klo; k <= khi; ++k) {
+              const amrex::Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+              const amrex::Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
+              zq += Zval*qvel;
+              q  += qvel;
+          }
+          qint(i,j,k0,0) = zq;
+          qint(i,j,k0,1) = q;
+      });
+    }
+
+    // Sum the parts of each column, then copy the totals back (including the lateral
+    //     ghost columns, which come from the periodic images where appropriate)
+    amrex::IntVect col_period(0);
+    for (int dir = 0; dir < 2; ++dir) {
+        if (geom.isPeriodic(dir)) col_period[dir] = dbx.length(dir);
+    }
+    const amrex::Periodicity xy_period(col_period);
+
+    MultiFab& total = mynn_columns->total;
+    total.setVal(0.0);
+    total.ParallelAdd(cols, 0, 0, 2, amrex::IntVect(1,1,0), amrex::IntVect(0));
+    cols.ParallelCopy(total, 0, 0, 2, amrex::IntVect(0), amrex::IntVect(1,1,0), xy_period);
+
+    amrex::Real dz_inv = geom.InvCellSize(2);
+    int izmin = geom.Domain().smallEnd(2);
+    int izmax = geom.Domain().bigEnd(2);
+    const amrex::Real l_obukhov = most->obukhov_len;
+    const amrex::Real surface_heat_flux = most->surf_temp_flux;
+    const amrex::Real theta0 = most->theta_mean; //(TODO: IS THIS ACTUALLY RHOTHETA)
+
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( amrex::MFIter mfi(eddyViscosity,amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+      const amrex::Box &bx = mfi.growntilebox(1);
+      const amrex::Array4<amrex::Real const > &cell_data = cons_in.array(mfi);
+      const amrex::Array4<amrex::Real> &K_turb = eddyViscosity.array(mfi);
+      const amrex::Array4<amrex::Real const> &uvel = xvel.array(mfi);
+      const amrex::Array4<amrex::Real const> &vvel = yvel.array(mfi);
+      const amrex::Array4<amrex::Real const> &qint = cols.const_array(mfi);
+
+      amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+      {
+          const amrex::Real qvel = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / cell_data(i,j,k,Rho_comp));
+          // We will divide by qvel later
+          AMREX_ASSERT_WITH_MESSAGE(qvel > 0.0, "QKE must have a positive value");
+
+          // Compute some partial derivatives that we will need (1st order at domain boundary)
+          // U and V derivatives are interpolated to account for staggered grid
+          amrex::Real dthetadz, dudz, dvdz;
+          if (k == izmax) {
+              dthetadz = (cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp) -
+                          cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+              dudz = 0.5*(uvel(i,j,k) - uvel(i,j,k-1) + uvel(i+1,j,k) - uvel(i+1,j,k-1))*dz_inv;
+              dvdz = 0.5*(vvel(i,j,k) - vvel(i,j,k-1) + vvel(i,j+1,k) - vvel(i,j+1,k-1))*dz_inv;
+          } else if (k == izmin){
+              dthetadz = (cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                          cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp))*dz_inv;
+              dudz = 0.5*(uvel(i,j,k+1) - uvel(i,j,k) + uvel(i+1,j,k+1) - uvel(i+1,j,k))*dz_inv;
+              dvdz = 0.5*(vvel(i,j,k+1) - vvel(i,j,k) + vvel(i,j+1,k+1) - vvel(i,j+1,k))*dz_inv;
+          } else {
+              dthetadz = 0.5*(cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                              cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+              dudz = 0.25*(uvel(i,j,k+1) - uvel(i,j,k-1) + uvel(i+1,j,k+1) - uvel(i+1,j,k-1))*dz_inv;
+              dvdz = 0.25*(vvel(i,j,k+1) - vvel(i,j,k-1) + vvel(i,j+1,k+1) - vvel(i,j+1,k-1))*dz_inv;
+          }
+
+          // First Length Scale
+          AMREX_ASSERT(l_obukhov != 0);
+          const amrex::Real zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+          const amrex::Real zeta = zval/l_obukhov;
+          amrex::Real l_S;
+          if (zeta >= 1.0) {
+              l_S = KAPPA*zval/3.7;
+          } else if (zeta >= 0) {
+              l_S = KAPPA*zval/(1+2.7*zeta);
+          } else {
+              l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
+          }
+
+          // Second Length Scale
+          amrex::Real l_T;
+          if (qint(i,j,izmin,1) > 0.0) {
+              l_T = 0.23*qint(i,j,izmin,0)/qint(i,j,izmin,1);
+          } else {
+              l_T = std::numeric_limits<amrex::Real>::max();
+          }
+
+          // Third Length Scale
+          amrex::Real l_B;
+          if (dthetadz > 0) {
+              amrex::Real N_brunt_vaisala = CONST_GRAV/theta0 * std::sqrt(dthetadz);
+              if (zeta < 0) {
+                  amrex::Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
+                  qc = std::pow(qc,1.0/3.0);
+                  l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel/N_brunt_vaisala;
+              } else {
+                  l_B = qvel / N_brunt_vaisala;
+              }
+          } else {
+              l_B = std::numeric_limits<amrex::Real>::max();
+          }
+
+          // Overall Length Scale
+          amrex::Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
+
+          // Compute non-dimensional parameters
+          amrex::Real l2_over_q2 = l_comb*l_comb/(qvel*qvel);
+          amrex::Real GM = l2_over_q2 * (dudz*dudz + dvdz*dvdz);
+          amrex::Real GH = -l2_over_q2 / theta0 * dthetadz;
+          amrex::Real E1 = 1.0 + 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH;
+          amrex::Real E2 = -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH;
+          amrex::Real E3 = 6.0*A2*A1*GM;
+          amrex::Real E4 = 1.0 - 12.0*A2*A1*(1.0-C2)*GH -3.0*A2*B2*(1.0-C3)*GH;
+          amrex::Real R1 = A1*(1.0-3.0*C1);
+
+          amrex::Real SM = (A2*E2 - R1*E4)/(E2*E3 - E1*E4);
+          amrex::Real SH = (R1*E3 - A2*E1)/(E2*E3 - E1*E4);
+          amrex::Real SQ = 3.0 * SM;
+
+          // Finally, compute the eddy viscosity/diffusivities
+          const amrex::Real rho = cell_data(i,j,k,Rho_comp);
+          K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel * SM;
+          K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel * SH;
+          K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel * 3.0 * SQ;
+
+          K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
+          // TODO: How should this be done for other components (scalars, moisture)
+      });
+    }
+  }
+}
+#endif
@@ -52,3 +52,63 @@ void VelocityToMomentum( const MultiFab& xvel_in, const MultiFab& yvel_in, const
         });
     } // end MFIter
 }
+
+/**
+ * Convert velocity to momentum on the ghost faces and on the faces that lie on the domain boundary,
+ * i.e. only where filling the velocity may have changed it. The momentum on the other valid faces
+ * is the prognostic state and is left untouched rather than recomputed from the velocity derived
+ * from it.
+ */
+void VelocityToMomentumOnFilledFaces( const MultiFab& xvel_in, const MultiFab& yvel_in, const MultiFab& zvel_in,
+                                      const MultiFab& cons_in,
+                                      MultiFab& xmom, MultiFab& ymom, MultiFab& zmom,
+                                      const IntVect& ngrow, const Box& domain)
+{
+    BL_PROFILE_VAR("VelocityToMomentumOnFilledFaces()",VelocityToMomentumOnFilledFaces);
+
+    const auto dom_lo = amrex::lbound(domain);
+    const auto dom_hi = amrex::ubound(domain);
+
+    // Loop over boxes = valid boxes grown by ngrow
+#ifdef _OPENMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for ( MFIter mfi(cons_in,TilingIfNotGPU()); mfi.isValid(); ++mfi)
+    {
+        const Box& vbx = mfi.validbox();
+        const Box& vbx_x = amrex::surroundingNodes(vbx,0);
+        const Box& vbx_y = amrex::surroundingNodes(vbx,1);
+        const Box& vbx_z = amrex::surroundingNodes(vbx,2);
+
+        const Box& tbx = amrex::grow(mfi.nodaltilebox(0),ngrow);
+        const Box& tby = amrex::grow(mfi.nodaltilebox(1),ngrow);
+        const Box& tbz = amrex::grow(mfi.nodaltilebox(2),ngrow);
+
+        // Conserved/state variables on cell centers -- we use this for density
+        const Array4<const Real>& cons = cons_in.array(mfi);
+
+        // Momentum on faces, to be computed
+        Array4<Real> const& momx = xmom.array(mfi);
+        Array4<Real> const& momy = ymom.array(mfi);
+        Array4<Real> const& momz = zmom.array(mfi);
+
+        // Velocity on faces, used in computation
+        const Array4<Real const>& velx = xvel_in.array(mfi);
+        const Array4<Real const>& vely = yvel_in.array(mfi);
+        const Array4<Real const>& velz = zvel_in.array(mfi);
+
+        amrex::ParallelFor(tbx, tby, tbz,
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+            if (vbx_x.contains(i,j,k) && i != dom_lo.x && i != dom_hi.x+1) return;
+            momx(i,j,k) = velx(i,j,k) * 0.5 * (cons(i,j,k,Rho_comp) + cons(i-1,j,k,Rho_comp));
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+            if (vbx_y.contains(i,j,k) && j != dom_lo.y && j != dom_hi.y+1) return;
+            momy(i,j,k) = vely(i,j,k) * 0.5 * (cons(i,j,k,Rho_comp) + cons(i,j-1,k,Rho_comp));
+        },
+        [=] AMREX_GPU_DEVICE (int i, int j, int k) {
+            if (vbx_z.contains(i,j,k) && k != dom_lo.z && k != dom_hi.z+1) return;
+            momz(i,j,k) = velz(i,j,k) * 0.5 * (cons(i,j,k,Rho_comp) + cons(i,j,k-1,Rho_comp));
+        });
+    } // end MFIter
+}
@@ -536,17 +536,19 @@ void erf_fast_rhs (int level,
 
         // Compute the RHS for the flux terms from this stage --
         //     we do it this way so we don't double count
-        amrex::ParallelFor(tbx, ncomp,
+        // (only the mass flux is kept if we are not refluxing)
+        const int nflux = amrex::min(ncomp, advflux_x.ncomp);
+        amrex::ParallelFor(tbx, nflux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             xflux_rhs(i,j,k,n) = advflux_x(i,j,k,n);
         });
-        amrex::ParallelFor(tby, ncomp,
+        amrex::ParallelFor(tby, nflux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             yflux_rhs(i,j,k,n) = advflux_y(i,j,k,n);
         });
-        amrex::ParallelFor(tbz, ncomp,
+        amrex::ParallelFor(tbz, nflux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n) noexcept
         {
             zflux_rhs(i,j,k,n) = advflux_z(i,j,k,n);
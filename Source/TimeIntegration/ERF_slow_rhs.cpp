@@ -1,3 +1,5 @@
+#include <type_traits>
+
 #include <AMReX.H>
 #include <AMReX_MultiFab.H>
 #include <AMReX_ArrayLim.H>
@@ -18,6 +20,488 @@
 
 using namespace amrex;
 
+// *************************************************************************
+// The slow RHS kernels are compiled once for each combination of the physics
+//     options they depend on, and erf_slow_rhs picks the instantiation once
+//     per call, so that the kernels hold no tests of options that are the
+//     same for every cell
+// *************************************************************************
+
+// The momentum forcing that is the same for every face; the driving pressure
+//     gradient, geostrophic forcing and gravity are zero when not used
+struct MomForcing {
+    GpuArray<Real,AMREX_SPACEDIM> pgrad;
+    GpuArray<Real,AMREX_SPACEDIM> geo;
+    Real grav_z;
+    Real cor_factor;
+    Real sinphi;
+    Real cosphi;
+};
+
+// Calls f with the three options as std::true_type or std::false_type
+template <typename F>
+void
+dispatch_options (bool a, bool b, bool c, F&& f)
+{
+    using T = std::true_type;
+    using X = std::false_type;
+    if (a) {
+        if (b) {
+            if (c) { f(T{}, T{}, T{}); } else { f(T{}, T{}, X{}); }
+        } else {
+            if (c) { f(T{}, X{}, T{}); } else { f(T{}, X{}, X{}); }
+        }
+    } else {
+        if (b) {
+            if (c) { f(X{}, T{}, T{}); } else { f(X{}, T{}, X{}); }
+        } else {
+            if (c) { f(X{}, X{}, T{}); } else { f(X{}, X{}, X{}); }
+        }
+    }
+}
+
+// Slow RHS of cell-centered component n: the terms that apply are fixed for
+//     each component (only theta is damped, only KE and QKE get the TKE terms)
+template <bool Diffuse, bool Rayleigh, bool KE, bool QKE>
+void
+slow_rhs_for_comp (const Box& bx, const int n,
+                   const Array4<Real>& cell_rhs,
+                   const Array4<const Real>& cell_data,
+                   const Array4<const Real>& cell_prim,
+                   const Array4<Real>& source_fab,
+                   const Array4<Real>& diffflux_x,
+                   const Array4<Real>& diffflux_y,
+                   const Array4<Real>& diffflux_z,
+                   const Array4<const Real>& u,
+                   const Array4<const Real>& v,
+#ifdef ERF_USE_TERRAIN
+                   const Array4<const Real>& w, const BCRec* bc_ptr,
+#else
+                   const Array4<const Real>& s_cc,
+                   const Array4<const Real>& s12,
+                   const Array4<const Real>& s13,
+                   const Array4<const Real>& s23,
+#endif
+                   const Array4<Real>& K_turb,
+                   const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                   const Box& domain, const SolverChoice& solverChoice,
+                   const Real* dptr_rayleigh_tau, const Real* dptr_rayleigh_thetabar,
+                   const Real grav_z, const Real l_Delta, const Real l_C_e,
+                   const Real theta_mean)
+{
+#ifdef ERF_NO_TKE
+    amrex::ignore_unused(u, v, domain, grav_z, l_Delta, l_C_e, theta_mean);
+#ifdef ERF_USE_TERRAIN
+    amrex::ignore_unused(w, bc_ptr);
+#else
+    amrex::ignore_unused(s_cc, s12, s13, s23);
+#endif
+#endif
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+    {
+        // Add diffusive terms.
+        if (Diffuse)
+            cell_rhs(i, j, k, n) += DiffusionSrcForState(i, j, k, cell_data, cell_prim, n,
+                                    diffflux_x, diffflux_y, diffflux_z, dxInv, K_turb, solverChoice);
+
+        // Add Rayleigh damping
+        if (Rayleigh)
+        {
+            Real theta = cell_prim(i,j,k,PrimTheta_comp);
+            cell_rhs(i, j, k, n) -= dptr_rayleigh_tau[k] * (theta - dptr_rayleigh_thetabar[k]) * cell_data(i,j,k,Rho_comp);
+        }
+
+#ifndef ERF_NO_TKE
+        if (KE)
+        {
+            // Add Buoyancy Source
+            Real theta     = cell_prim(i,j,k,PrimTheta_comp);
+            Real dtheta_dz = 0.5*(cell_prim(i,j,k+1,PrimTheta_comp)-cell_prim(i,j,k-1,PrimTheta_comp))*dxInv[2];
+            Real E         = cell_prim(i,j,k,PrimKE_comp);
+            Real length;
+            if (dtheta_dz <= 0.) {
+               length = l_Delta;
+            } else {
+               length = 0.76*std::sqrt(E)*(grav_z/theta)*dtheta_dz;
+            }
+            Real KH   = 0.1 * (1.+2.*length/l_Delta) * std::sqrt(E);
+            cell_rhs(i, j, k, n) += cell_data(i,j,k,Rho_comp) * grav_z * KH * dtheta_dz;
+
+            // Add TKE production
+#ifdef ERF_USE_TERRAIN
+            cell_rhs(i, j, k, n) += ComputeTKEProduction(i,j,k,u,v,w,K_turb,dxInv,domain,bc_ptr);
+#else
+            cell_rhs(i, j, k, n) += ComputeTKEProduction(i,j,k,K_turb,s_cc,s12,s13,s23);
+#endif
+
+            // Add dissipation
+            if (std::abs(E) > 0.) {
+                cell_rhs(i, j, k, n) += cell_data(i,j,k,Rho_comp) * l_C_e *
+                    std::pow(E,1.5) / length;
+            }
+        }
+
+        // QKE : similar terms to TKE
+        if (QKE) {
+             cell_rhs(i,j,k,n) += ComputeQKESourceTerms(i,j,k,u,v,cell_data,cell_prim,
+                                                        K_turb,dxInv,domain,solverChoice,theta_mean);
+        }
+#endif
+
+        // Add source terms. TODO: Put this under an if condition when we implement source term
+        cell_rhs(i, j, k, n) += source_fab(i, j, k, n);
+    });
+}
+
+// Slow RHS of the x-momentum equation
+template <bool Diffuse, bool Coriolis, bool Rayleigh>
+void
+slow_rhs_for_xmom (const Box& tbx, const int level, const int vlo_x, const int vhi_x,
+                   const Array4<const int>& mlo_x, const Array4<const int>& mhi_x,
+                   const Array4<Real>& rho_u_rhs,
+                   const Array4<const Real>& rho_u,
+                   const Array4<const Real>& rho_v,
+                   const Array4<const Real>& rho_w,
+                   const Array4<const Real>& u,
+                   const Array4<const Real>& v,
+                   const Array4<const Real>& w,
+                   const Array4<const Real>& cell_data,
+                   const Array4<const Real>& cell_prim,
+                   const Array4<Real>& pp_arr,
+#ifdef ERF_USE_TERRAIN
+                   const Array4<const Real>& z_nd,
+                   const Array4<const Real>& detJ,
+                   const Box& domain, const BCRec* bc_ptr,
+#else
+                   const Array4<const Real>& s_cc,
+                   const Array4<const Real>& s12,
+                   const Array4<const Real>& s13,
+                   const Array4<const Real>& s23,
+#endif
+                   const Array4<Real>& K_turb,
+                   const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                   const int l_spatial_order, const SolverChoice& solverChoice,
+                   const MomForcing& forcing,
+                   const Real* dptr_rayleigh_tau, const Real* dptr_rayleigh_ubar)
+{
+    amrex::ignore_unused(cell_prim);
+    amrex::ParallelFor(tbx,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) { // x-momentum equation
+
+        rho_u_rhs(i, j, k) = 0.0; // Initialize the updated x-mom eqn term to zero
+
+        bool on_coarse_fine_boundary = false;
+        if (level > 0)
+        {
+           on_coarse_fine_boundary =
+             ( (i == vlo_x && mlo_x(i,j,k)) || (i == vhi_x+1 && mhi_x(i,j,k)) );
+        }
+
+        if (!on_coarse_fine_boundary)
+        {
+
+        // Add advective terms
+        rho_u_rhs(i, j, k) += -AdvectionSrcForXMom(i, j, k, rho_u, rho_v, rho_w, u,
+#ifdef ERF_USE_TERRAIN
+                                                   z_nd, detJ,
+#endif
+                                                   dxInv, l_spatial_order);
+
+        // Add diffusive terms
+        if (Diffuse) {
+            rho_u_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
+                                                     MomentumEqn::x, dxInv, K_turb, solverChoice,
+#ifdef ERF_USE_TERRAIN
+                                                     z_nd, detJ, domain, bc_ptr);
+#else
+                                                     s_cc, s12, s13, s23);
+#endif
+        }
+
+        // Add pressure gradient
+#ifdef ERF_USE_TERRAIN
+        Real met_h_xi,met_h_eta,met_h_zeta;
+        ComputeMetricAtIface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_xi_zeta);
+        Real gp_xi = dxInv[0] * (pp_arr(i,j,k) - pp_arr(i-1,j,k));
+        Real gp_zeta_on_iface = (k == 0) ?
+            0.5 * dxInv[2] * (
+            pp_arr(i,j,k+1) + pp_arr(i-1,j,k+1) - pp_arr(i,j,k) - pp_arr(i-1,j,k)):
+            0.25 * dxInv[2] * (
+              pp_arr(i,j,k+1) + pp_arr(i-1,j,k+1) - pp_arr(i,j,k-1) - pp_arr(i-1,j,k-1));
+        amrex::Real gpx = gp_xi - (met_h_xi/ met_h_zeta) * gp_zeta_on_iface;
+#else
+        amrex::Real gpx = dxInv[0] * (pp_arr(i,j,k) - pp_arr(i-1,j,k));
+#endif
+#ifdef ERF_USE_MOISUTRE
+        Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i-1,j,k,PrimQv_comp)
+                        +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i-1,j,k,PrimQc_comp) );
+        rho_u_rhs(i, j, k) -= gpx / (1.0 + q);
+#else
+        rho_u_rhs(i, j, k) -= gpx;
+#endif
+
+        // Add driving pressure gradient
+        rho_u_rhs(i, j, k) += forcing.pgrad[0];
+
+        // Add Coriolis forcing (that assumes east is +x, north is +y)
+        if (Coriolis)
+        {
+            Real rho_v_loc = 0.25 * (rho_v(i,j+1,k) + rho_v(i,j,k) + rho_v(i-1,j+1,k) + rho_v(i-1,j,k));
+            Real rho_w_loc = 0.25 * (rho_w(i,j,k+1) + rho_w(i,j,k) + rho_w(i,j-1,k+1) + rho_w(i,j-1,k));
+            rho_u_rhs(i, j, k) += forcing.cor_factor * (rho_v_loc * forcing.sinphi - rho_w_loc * forcing.cosphi);
+        }
+
+        // Add geostrophic forcing
+        rho_u_rhs(i, j, k) += forcing.geo[0];
+
+        // Add Rayleigh damping
+        if (Rayleigh)
+        {
+            Real uu = rho_u(i,j,k) / cell_data(i,j,k,Rho_comp);
+            rho_u_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (uu - dptr_rayleigh_ubar[k]) * cell_data(i,j,k,Rho_comp);
+        }
+
+        } // not on coarse-fine boundary
+    });
+}
+
+// Slow RHS of the y-momentum equation
+template <bool Diffuse, bool Coriolis, bool Rayleigh>
+void
+slow_rhs_for_ymom (const Box& tby, const int level, const int vlo_y, const int vhi_y,
+                   const Array4<const int>& mlo_y, const Array4<const int>& mhi_y,
+                   const Array4<Real>& rho_v_rhs,
+                   const Array4<const Real>& rho_u,
+                   const Array4<const Real>& rho_v,
+                   const Array4<const Real>& rho_w,
+                   const Array4<const Real>& u,
+                   const Array4<const Real>& v,
+                   const Array4<const Real>& w,
+                   const Array4<const Real>& cell_data,
+                   const Array4<const Real>& cell_prim,
+                   const Array4<Real>& pp_arr,
+#ifdef ERF_USE_TERRAIN
+                   const Array4<const Real>& z_nd,
+                   const Array4<const Real>& detJ,
+                   const Box& domain, const BCRec* bc_ptr,
+#else
+                   const Array4<const Real>& s_cc,
+                   const Array4<const Real>& s12,
+                   const Array4<const Real>& s13,
+                   const Array4<const Real>& s23,
+#endif
+                   const Array4<Real>& K_turb,
+                   const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                   const int l_spatial_order, const SolverChoice& solverChoice,
+                   const MomForcing& forcing,
+                   const Real* dptr_rayleigh_tau, const Real* dptr_rayleigh_vbar)
+{
+    amrex::ignore_unused(cell_prim);
+    amrex::ParallelFor(tby,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) { // y-momentum equation
+
+        rho_v_rhs(i, j, k) = 0.0; // Initialize the updated y-mom eqn term to zero
+
+        bool on_coarse_fine_boundary = false;
+        if (level > 0)
+        {
+           on_coarse_fine_boundary =
+             ( (j == vlo_y && mlo_y(i,j,k)) || (j == vhi_y+1 && mhi_y(i,j,k)) );
+        }
+
+        if (!on_coarse_fine_boundary)
+        {
+
+        // Add advective terms
+        rho_v_rhs(i, j, k) += -AdvectionSrcForYMom(i, j, k, rho_u, rho_v, rho_w, v,
+#ifdef ERF_USE_TERRAIN
+                                                   z_nd, detJ,
+#endif
+                                                   dxInv, l_spatial_order);
+
+        // Add diffusive terms
+        if (Diffuse) {
+            rho_v_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
+                                                     MomentumEqn::y, dxInv, K_turb, solverChoice,
+#ifdef ERF_USE_TERRAIN
+                                                     z_nd, detJ, domain, bc_ptr);
+#else
+                                                     s_cc, s12, s13, s23);
+#endif
+        }
+
+        // Add pressure gradient
+#ifdef ERF_USE_TERRAIN
+        Real met_h_xi,met_h_eta,met_h_zeta;
+        ComputeMetricAtJface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_eta_zeta);
+        Real gp_eta = dxInv[1] * (pp_arr(i,j,k) - pp_arr(i,j-1,k));
+        Real gp_zeta_on_jface = (k == 0) ?
+            0.5 * dxInv[2] * (
+              pp_arr(i,j,k+1) + pp_arr(i,j-1,k+1) - pp_arr(i,j,k) - pp_arr(i,j-1,k)):
+            0.25 * dxInv[2] * (
+              pp_arr(i,j,k+1) + pp_arr(i,j-1,k+1) - pp_arr(i,j,k-1) - pp_arr(i,j-1,k-1));
+        amrex::Real gpy = gp_eta - (met_h_eta / met_h_zeta) * gp_zeta_on_jface;
+#else
+        amrex::Real gpy = dxInv[1] * (pp_arr(i,j,k) - pp_arr(i,j-1,k));
+#endif
+#ifdef ERF_USE_MOISUTRE
+        Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i,j-1,k,PrimQv_comp)
+                        +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i,j-1,k,PrimQc_comp) );
+        rho_v_rhs(i, j, k) -= gpy / (1.0_rt + q);
+#else
+        rho_v_rhs(i, j, k) -= gpy;
+#endif
+
+        // Add driving pressure gradient
+        rho_v_rhs(i, j, k) += forcing.pgrad[1];
+
+        // Add Coriolis forcing (that assumes east is +x, north is +y)
+        if (Coriolis)
+        {
+            Real rho_u_loc = 0.25 * (rho_u(i+1,j,k) + rho_u(i,j,k) + rho_u(i+1,j-1,k) + rho_u(i,j-1,k));
+            rho_v_rhs(i, j, k) += -forcing.cor_factor * rho_u_loc * forcing.sinphi;
+        }
+
+        // Add geostrophic forcing
+        rho_v_rhs(i, j, k) += forcing.geo[1];
+
+        // Add Rayleigh damping
+        if (Rayleigh)
+        {
+            Real vv = rho_v(i,j,k) / cell_data(i,j,k,Rho_comp);
+            rho_v_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (vv - dptr_rayleigh_vbar[k]) * cell_data(i,j,k,Rho_comp);
+        }
+
+        } // not on coarse-fine boundary
+    });
+}
+
+// Slow RHS of the z-momentum equation
+template <bool Diffuse, bool Coriolis, bool Rayleigh>
+void
+slow_rhs_for_zmom (const Box& tbz, const int level, const int vlo_z, const int vhi_z,
+                   const Array4<const int>& mlo_z, const Array4<const int>& mhi_z,
+                   const int domhi_z,
+                   const Array4<Real>& rho_w_rhs,
+                   const Array4<const Real>& rho_u,
+                   const Array4<const Real>& rho_v,
+                   const Array4<const Real>& rho_w,
+                   const Array4<const Real>& u,
+                   const Array4<const Real>& v,
+                   const Array4<const Real>& w,
+                   const Array4<const Real>& cell_data,
+                   const Array4<const Real>& cell_prim,
+                   const Array4<Real>& pp_arr,
+#ifdef ERF_USE_TERRAIN
+                   const Array4<const Real>& z_nd,
+                   const Array4<const Real>& detJ,
+                   const Box& domain, const BCRec* bc_ptr,
+                   const Array4<const Real>& r0_arr,
+#else
+                   const Array4<const Real>& s_cc,
+                   const Array4<const Real>& s12,
+                   const Array4<const Real>& s13,
+                   const Array4<const Real>& s23,
+                   const Real* dptr_dens_hse,
+#endif
+                   const Array4<Real>& K_turb,
+                   const GpuArray<Real,AMREX_SPACEDIM>& dxInv,
+                   const int l_spatial_order, const SolverChoice& solverChoice,
+                   const MomForcing& forcing,
+                   const Real* dptr_rayleigh_tau)
+{
+    amrex::ignore_unused(cell_prim);
+    amrex::ParallelFor(tbz,
+    [=] AMREX_GPU_DEVICE (int i, int j, int k) { // z-momentum equation
+
+        rho_w_rhs(i, j, k) = 0.0; // Initialize the updated z-mom eqn term to zero
+
+        bool on_coarse_fine_boundary = false;
+        if (level > 0)
+        {
+           on_coarse_fine_boundary =
+             ( (k == vlo_z && mlo_z(i,j,k)) || (k == vhi_z+1 && mhi_z(i,j,k)) );
+        }
+
+        if (!on_coarse_fine_boundary)
+        {
+
+        // Add advective terms
+        rho_w_rhs(i, j, k) += -AdvectionSrcForZMom(i, j, k, rho_u, rho_v, rho_w, w,
+#ifdef ERF_USE_TERRAIN
+                                                   z_nd, detJ,
+#endif
+                                                   dxInv, l_spatial_order);
+
+        // Add diffusive terms
+        if (Diffuse) {
+            rho_w_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
+                                                     MomentumEqn::z, dxInv, K_turb, solverChoice,
+#ifdef ERF_USE_TERRAIN
+                                                     z_nd, detJ, domain, bc_ptr);
+#else
+                                                     s_cc, s12, s13, s23);
+#endif
+        }
+
+        // Add pressure gradient
+#ifdef ERF_USE_TERRAIN
+        Real met_h_xi,met_h_eta,met_h_zeta;
+        ComputeMetricAtKface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_zeta);
+        amrex::Real gpz = dxInv[2] * (pp_arr(i,j,k) - pp_arr(i,j,k-1)) / met_h_zeta;
+#else
+        amrex::Real gpz = dxInv[2] * (pp_arr(i,j,k) - pp_arr(i,j,k-1));
+#endif
+#ifdef ERF_USE_MOISUTRE
+        Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i,j,k-1,PrimQv_comp)
+                        +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i,j,k-1,PrimQc_comp) );
+        rho_w_rhs(i, j, k) -= gpz / (1.0_rt + q);
+#else
+        rho_w_rhs(i, j, k) -= gpz;
+#endif
+
+        // Add gravity term
+        int local_spatial_order = 2;
+        rho_w_rhs(i, j, k) += forcing.grav_z *
+#ifdef ERF_USE_TERRAIN
+             InterpolateDensityPertFromCellToFace(i, j, k, cell_data, rho_w(i,j,k),
+                                                  Coord::z, local_spatial_order, r0_arr);
+#else
+             InterpolateDensityPertFromCellToFace(i, j, k, cell_data, rho_w(i,j,k),
+                                                  Coord::z, local_spatial_order, dptr_dens_hse);
+#endif
+
+        // Add driving pressure gradient
+        rho_w_rhs(i, j, k) += forcing.pgrad[2];
+
+        // Add Coriolis forcing (that assumes east is +x, north is +y)
+        if (Coriolis)
+        {
+            Real rho_u_loc = 0.25 * (rho_u(i+1,j,k) + rho_u(i,j,k) + rho_u(i+1,j,k-1) + rho_u(i,j,k-1));
+            rho_w_rhs(i, j, k) += forcing.cor_factor * rho_u_loc * forcing.cosphi;
+        }
+
+        // Add geostrophic forcing
+        rho_w_rhs(i, j, k) += forcing.geo[2];
+
+        // Add Rayleigh damping
+        if (Rayleigh)
+        {
+            rho_w_rhs(i, j, k) -= dptr_rayleigh_tau[k] * rho_w(i,j,k);
+        }
+
+        // Enforce no forcing term at bottom boundary
+        if (k == 0) {
+            rho_w_rhs(i,j,k) = 0.;
+        } else if (k == domhi_z+1) {
+            //rho_w_rhs(i, j, k) = rho_w_rhs(i,j,k-1);
+            rho_w_rhs(i, j, k) = 0.;
+        }
+
+        } // not on coarse-fine boundary
+    });
+}
+
 void erf_slow_rhs (int level,
                    Vector<MultiFab>& S_rhs,
                    const Vector<MultiFab>& S_data,
@@ -29,6 +513,9 @@ void erf_slow_rhs (int level,
                    MultiFab& source,
                    std::array< MultiFab, AMREX_SPACEDIM>&  advflux,
                    std::array< MultiFab, AMREX_SPACEDIM>& diffflux,
+                   MultiFab* eddyDiffs, bool update_eddy_diffs,
+                   Vector<MultiFab>* strain, int& strain_valid,
+                   MYNNColumns* mynn_columns,
                    const amrex::Geometry geom,
                          amrex::InterpFaceRegister* ifr,
                    const SolverChoice& solverChoice,
@@ -90,16 +577,51 @@ void erf_slow_rhs (int level,
     // PBL - only updates vertical eddy viscosity components so horizontal
     //       components come from the LES model or are left as zero.
     // *************************************************************************
-    MultiFab eddyDiffs(S_data[IntVar::cons].boxArray(),S_data[IntVar::cons].DistributionMap(),EddyDiff::NumDiffs,1);
-    ComputeTurbulentViscosity(xvel, yvel, zvel, S_data[IntVar::cons],
-                              eddyDiffs, geom, solverChoice, most, domain_bcs_type_d);
+    const bool l_use_diff = ( (solverChoice.molec_diff_type != MolecDiffType::None) ||
+                              (solverChoice.les_type        !=       LESType::None) ||
+                              (solverChoice.pbl_type        !=       PBLType::None) );
+
+    bool l_use_QKE       = solverChoice.use_QKE && solverChoice.advect_QKE;
+    bool l_use_deardorff = (solverChoice.les_type == LESType::Deardorff);
+
+    auto in_range = [=] (int n) { return (n >= start_comp && n < start_comp + num_comp); };
+
+    // The eddy viscosity is computed once per stage, by the first call here, and
+    //     reused by the later calls in the stage; with only molecular diffusion (or none)
+    //     there is no eddy viscosity at all and eddyDiffs is null
+    const bool l_use_turb = (eddyDiffs != nullptr);
+
+    // *************************************************************************
+    // The strain rate tensor and expansion rate are evaluated once per stage, by
+    //     the first call that needs them, and shared by the eddy viscosity, the
+    //     momentum diffusion and the TKE production -- a call that updates none
+    //     of these (the slow variables without Deardorff, say) doesn't need them
+    // *************************************************************************
+#ifndef ERF_USE_TERRAIN
+    const bool l_use_strain = (strain != nullptr);
+#ifndef ERF_NO_TKE
+    const bool l_update_KE = l_use_deardorff && in_range(RhoKE_comp);
+#else
+    const bool l_update_KE = false;
+#endif
+    if (l_use_strain && !strain_valid &&
+        ( (l_use_turb && update_eddy_diffs) || (rhs_vars != RHSVar::slow) || l_update_KE ) )
+    {
+        ComputeStrainRates(xvel, yvel, zvel, *strain, geom, domain_bcs_type_d);
+        strain_valid = 1;
+    }
+#endif
+
+    if (l_use_turb && update_eddy_diffs) {
+        ComputeTurbulentViscosity(xvel, yvel, zvel, S_data[IntVar::cons],
+                                  *eddyDiffs, geom, solverChoice, most, mynn_columns, domain_bcs_type_d,
+                                  false, strain);
+    }
 
     const iMultiFab *mlo_mf_x, *mhi_mf_x;
     const iMultiFab *mlo_mf_y, *mhi_mf_y;
     const iMultiFab *mlo_mf_z, *mhi_mf_z;
 
-    bool l_use_QKE       = solverChoice.use_QKE && solverChoice.advect_QKE;
-    bool l_use_deardorff = (solverChoice.les_type == LESType::Deardorff);
     Real l_Delta         = std::pow(dx[0] * dx[1] * dx[2],1./3.);
     Real l_C_e           = solverChoice.Ce;
 
@@ -115,6 +637,50 @@ void erf_slow_rhs (int level,
 
     MultiFab pprime(S_data[IntVar::cons].boxArray(), S_data[IntVar::cons].DistributionMap(), 1, 1);
 
+    // *************************************************************************
+    // The physics options are decided once here rather than per cell: each
+    //     component picks the instantiation of slow_rhs_for_comp with the terms
+    //     it needs, the momentum kernels are instantiated for the diffusion,
+    //     Coriolis and Rayleigh options, and the other momentum forcing is a
+    //     constant that is zero when not used
+    // *************************************************************************
+    const bool l_use_rayleigh = solverChoice.use_rayleigh_damping;
+    const bool l_use_coriolis = solverChoice.use_coriolis;
+    const bool l_use_gravity  = solverChoice.use_gravity;
+    const bool l_use_pgrad    = (solverChoice.abl_driver_type == ABLDriverType::PressureGradient);
+    const bool l_use_geo      = (solverChoice.abl_driver_type == ABLDriverType::GeostrophicWind);
+
+    Array<bool,NVAR> l_diffuse;
+    for (int n = 0; n < NVAR; ++n) l_diffuse[n] = false;
+    if (in_range(RhoTheta_comp))                    l_diffuse[RhoTheta_comp]  = true;
+    if (in_range(RhoScalar_comp))                   l_diffuse[RhoScalar_comp] = true;
+#ifndef ERF_NO_TKE
+    if (l_use_deardorff && in_range(RhoKE_comp))    l_diffuse[RhoKE_comp]     = true;
+    if (l_use_QKE       && in_range(RhoQKE_comp))   l_diffuse[RhoQKE_comp]    = true;
+#endif
+
+    const int l_rayleigh_comp = (l_use_rayleigh  && in_range(RhoTheta_comp)) ? RhoTheta_comp : -1;
+#ifndef ERF_NO_TKE
+    const int l_KE_comp       = (l_use_deardorff && in_range(RhoKE_comp))    ? RhoKE_comp    : -1;
+    const int l_QKE_comp      = (l_use_QKE       && in_range(RhoQKE_comp))   ? RhoQKE_comp   : -1;
+#endif
+
+    MomForcing l_forcing;
+    for (int d = 0; d < AMREX_SPACEDIM; ++d) {
+        l_forcing.pgrad[d] = l_use_pgrad ? -solverChoice.abl_pressure_grad[d] : 0.0;
+        l_forcing.geo[d]   = l_use_geo   ?  solverChoice.abl_geo_forcing[d]   : 0.0;
+    }
+    l_forcing.grav_z     = l_use_gravity ? grav_gpu[2] : 0.0;
+    l_forcing.cor_factor = solverChoice.coriolis_factor;
+    l_forcing.sinphi     = solverChoice.sinphi;
+    l_forcing.cosphi     = solverChoice.cosphi;
+
+    // Only the components of the fluxes we store (all if we reflux, otherwise only the mass flux)
+    //     are carried through the integrator
+    const bool store_diffflux = diffflux[0].ok();
+    const int flux_end = amrex::min(start_comp + num_comp, S_rhs[IntVar::xflux].nComp());
+    const int num_flux = amrex::max(flux_end - start_comp, 0);
+
     // *************************************************************************
     // Define updates and fluxes in the current RK stage
     // *************************************************************************
@@ -178,10 +744,10 @@ void erf_slow_rhs (int level,
         const Array4<Real>& advflux_y = advflux[1].array(mfi);
         const Array4<Real>& advflux_z = advflux[2].array(mfi);
 
-        // These are temporaries we use to add to the S_rhs for the fluxes
-        const Array4<Real>& diffflux_x = diffflux[0].array(mfi);
-        const Array4<Real>& diffflux_y = diffflux[1].array(mfi);
-        const Array4<Real>& diffflux_z = diffflux[2].array(mfi);
+        // These are temporaries we use to add to the S_rhs for the fluxes (only defined if we reflux)
+        const Array4<Real>& diffflux_x = store_diffflux ? diffflux[0].array(mfi) : Array4<Real>{};
+        const Array4<Real>& diffflux_y = store_diffflux ? diffflux[1].array(mfi) : Array4<Real>{};
+        const Array4<Real>& diffflux_z = store_diffflux ? diffflux[2].array(mfi) : Array4<Real>{};
 
 #ifdef ERF_USE_TERRAIN
         // These are metric terms for terrain-fitted coordiantes
@@ -189,7 +755,15 @@ void erf_slow_rhs (int level,
         const Array4<const Real>& detJ = detJ_cc.const_array(mfi);
 #endif
 
-        const Array4<Real>& K_turb = eddyDiffs.array(mfi);
+        const Array4<Real>& K_turb = l_use_turb ? eddyDiffs->array(mfi) : Array4<Real>{};
+
+#ifndef ERF_USE_TERRAIN
+        // Strain rates for this stage (only defined if there is any diffusion)
+        const Array4<const Real>& s_cc = l_use_strain ? (*strain)[Strain::cc].const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& s12  = l_use_strain ? (*strain)[Strain::xy].const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& s13  = l_use_strain ? (*strain)[Strain::xz].const_array(mfi) : Array4<const Real>{};
+        const Array4<const Real>& s23  = l_use_strain ? (*strain)[Strain::yz].const_array(mfi) : Array4<const Real>{};
+#endif
 
 #ifdef ERF_USE_TERRAIN
         const Array4<const Real>& r0_arr = r0.const_array(mfi);
@@ -230,92 +804,65 @@ void erf_slow_rhs (int level,
                                  dxInv, l_spatial_order, l_use_deardorff, l_use_QKE);
         }
 
-        amrex::ParallelFor(bx, num_comp,
-                           [=] AMREX_GPU_DEVICE (int i, int j, int k, int n_in) noexcept
+        for (int n = start_comp; n < start_comp + num_comp; ++n)
         {
-            int n = start_comp + n_in;
-
-            // Add diffusive terms.
-            if (n == RhoTheta_comp)
-                cell_rhs(i, j, k, n) += DiffusionSrcForState(i, j, k, cell_data, cell_prim, RhoTheta_comp,
-                                        diffflux_x, diffflux_y, diffflux_z, dxInv, K_turb, solverChoice);
-            if (n == RhoScalar_comp)
-                cell_rhs(i, j, k, n) += DiffusionSrcForState(i, j, k, cell_data, cell_prim, RhoScalar_comp,
-                                        diffflux_x, diffflux_y, diffflux_z, dxInv, K_turb, solverChoice);
-            if (l_use_deardorff && n == RhoKE_comp)
-                cell_rhs(i, j, k, n) += DiffusionSrcForState(i, j, k, cell_data, cell_prim, RhoKE_comp,
-                                        diffflux_x, diffflux_y, diffflux_z, dxInv, K_turb, solverChoice);
-            if (l_use_QKE && n == RhoQKE_comp)
-                cell_rhs(i, j, k, n) += DiffusionSrcForState(i, j, k, cell_data, cell_prim, RhoQKE_comp,
-                                        diffflux_x, diffflux_y, diffflux_z, dxInv, K_turb, solverChoice);
-
-            // Add Rayleigh damping
-            if (solverChoice.use_rayleigh_damping && n == RhoTheta_comp)
+            auto comp_rhs = [&] (auto diffuse, auto rayleigh, auto ke, auto qke)
             {
-                Real theta = cell_prim(i,j,k,PrimTheta_comp);
-                cell_rhs(i, j, k, n) -= dptr_rayleigh_tau[k] * (theta - dptr_rayleigh_thetabar[k]) * cell_data(i,j,k,Rho_comp);
-            }
-
-            if (l_use_deardorff && n == RhoKE_comp)
-            {
-                // Add Buoyancy Source
-                Real theta     = cell_prim(i,j,k,PrimTheta_comp);
-                Real dtheta_dz = 0.5*(cell_prim(i,j,k+1,PrimTheta_comp)-cell_prim(i,j,k-1,PrimTheta_comp))*dxInv[2];
-                Real E         = cell_prim(i,j,k,PrimKE_comp);
-                Real length;
-                if (dtheta_dz <= 0.) {
-                   length = l_Delta;
-                } else {
-                   length = 0.76*std::sqrt(E)*(grav_gpu[2]/theta)*dtheta_dz;
-                }
-                Real KH   = 0.1 * (1.+2.*length/l_Delta) * std::sqrt(E);
-                cell_rhs(i, j, k, n) += cell_data(i,j,k,Rho_comp) * grav_gpu[2] * KH * dtheta_dz;
-
-                // Add TKE production
-                cell_rhs(i, j, k, n) += ComputeTKEProduction(i,j,k,u,v,w,K_turb,dxInv,domain,bc_ptr);
-
-                // Add dissipation
-                if (std::abs(E) > 0.) {
-                    cell_rhs(i, j, k, n) += cell_data(i,j,k,Rho_comp) * l_C_e *
-                        std::pow(E,1.5) / length;
-                }
-            }
-
-            // QKE : similar terms to TKE
-            if (l_use_QKE && n == RhoQKE_comp) {
-                 cell_rhs(i,j,k,n) += ComputeQKESourceTerms(i,j,k,u,v,cell_data,cell_prim,
-                                                            K_turb,dxInv,domain,solverChoice,theta_mean);
+                slow_rhs_for_comp<decltype(diffuse)::value, decltype(rayleigh)::value,
+                                  decltype(ke)::value, decltype(qke)::value>(
+                    bx, n, cell_rhs, cell_data, cell_prim, source_fab,
+                    diffflux_x, diffflux_y, diffflux_z, u, v,
+#ifdef ERF_USE_TERRAIN
+                    w, bc_ptr,
+#else
+                    s_cc, s12, s13, s23,
+#endif
+                    K_turb, dxInv, domain, solverChoice,
+                    dptr_rayleigh_tau, dptr_rayleigh_thetabar,
+                    grav_gpu[2], l_Delta, l_C_e, theta_mean);
+            };
+            using T = std::true_type;
+            using X = std::false_type;
+            if (n == l_rayleigh_comp) {
+                comp_rhs(T{}, T{}, X{}, X{});
+#ifndef ERF_NO_TKE
+            } else if (n == l_KE_comp) {
+                comp_rhs(T{}, X{}, T{}, X{});
+            } else if (n == l_QKE_comp) {
+                comp_rhs(T{}, X{}, X{}, T{});
+#endif
+            } else if (l_diffuse[n]) {
+                comp_rhs(T{}, X{}, X{}, X{});
+            } else {
+                comp_rhs(X{}, X{}, X{}, X{});
             }
-
-            // Add source terms. TODO: Put this under an if condition when we implement source term
-            cell_rhs(i, j, k, n) += source_fab(i, j, k, n);
-        });
+        }
 
         // Compute the RHS for the flux terms from this stage -- we do it this way so we don't double count
         //         fluxes at fine-fine interfaces
         int rc = Rho_comp;
         int update_mom = (S_scratch.size() > 0);
-        amrex::ParallelFor(tbx, num_comp,
+        amrex::ParallelFor(tbx, num_flux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n_in) noexcept
         {
              int n = start_comp + n_in;
-             xflux_rhs(i,j,k,n) = advflux_x(i,j,k,n) + diffflux_x(i,j,k,n);
+             xflux_rhs(i,j,k,n) = advflux_x(i,j,k,n) + (diffflux_x ? diffflux_x(i,j,k,n) : 0.0);
              if (update_mom && n == rc) // Only update if we are computing source for density
                  avg_xmom(i,j,k) = advflux_x(i,j,k,0);
         });
-        amrex::ParallelFor(tby, num_comp,
+        amrex::ParallelFor(tby, num_flux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n_in) noexcept
         {
              int n = start_comp + n_in;
-             yflux_rhs(i,j,k,n) = advflux_y(i,j,k,n) + diffflux_y(i,j,k,n);
+             yflux_rhs(i,j,k,n) = advflux_y(i,j,k,n) + (diffflux_y ? diffflux_y(i,j,k,n) : 0.0);
              if (update_mom && n == rc) // Only update if we are computing source for density
                  avg_ymom(i,j,k) = advflux_y(i,j,k,0);
         });
-        amrex::ParallelFor(tbz, num_comp,
+        amrex::ParallelFor(tbz, num_flux,
         [=] AMREX_GPU_DEVICE (int i, int j, int k, int n_in) noexcept
         {
              int n = start_comp + n_in;
-             zflux_rhs(i,j,k,n) = advflux_z(i,j,k,n) + diffflux_z(i,j,k,n);
+             zflux_rhs(i,j,k,n) = advflux_z(i,j,k,n) + (diffflux_z ? diffflux_z(i,j,k,n) : 0.0);
              if (update_mom && n == rc) // Only update if we are computing source for density
                  avg_zmom(i,j,k) = advflux_z(i,j,k,0);
         });
@@ -324,250 +871,42 @@ void erf_slow_rhs (int level,
         // Define updates in the RHS of {x, y, z}-momentum equations
         // *********************************************************************
         if (rhs_vars != RHSVar::slow) {
-        amrex::ParallelFor(tbx,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) { // x-momentum equation
-
-            rho_u_rhs(i, j, k) = 0.0; // Initialize the updated x-mom eqn term to zero
-
-            bool on_coarse_fine_boundary = false;
-            if (level > 0)
-            {
-               on_coarse_fine_boundary =
-                 ( (i == vlo_x && mlo_x(i,j,k)) || (i == vhi_x+1 && mhi_x(i,j,k)) );
-            }
-
-            if (!on_coarse_fine_boundary)
-            {
-
-            // Add advective terms
-            rho_u_rhs(i, j, k) += -AdvectionSrcForXMom(i, j, k, rho_u, rho_v, rho_w, u,
-#ifdef ERF_USE_TERRAIN
-                                                       z_nd, detJ,
-#endif
-                                                       dxInv, l_spatial_order);
-
-            // Add diffusive terms
-            rho_u_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
-                                                     MomentumEqn::x, dxInv, K_turb, solverChoice,
-#ifdef ERF_USE_TERRAIN
-                                                     z_nd, detJ,
-#endif
-                                                     domain, bc_ptr);
-
-            // Add pressure gradient
-#ifdef ERF_USE_TERRAIN
-            Real met_h_xi,met_h_eta,met_h_zeta;
-            ComputeMetricAtIface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_xi_zeta);
-            Real gp_xi = dxInv[0] * (pp_arr(i,j,k) - pp_arr(i-1,j,k));
-            Real gp_zeta_on_iface = (k == 0) ?
-                0.5 * dxInv[2] * (
-                pp_arr(i,j,k+1) + pp_arr(i-1,j,k+1) - pp_arr(i,j,k) - pp_arr(i-1,j,k)):
-                0.25 * dxInv[2] * (
-                  pp_arr(i,j,k+1) + pp_arr(i-1,j,k+1) - pp_arr(i,j,k-1) - pp_arr(i-1,j,k-1));
-            amrex::Real gpx = gp_xi - (met_h_xi/ met_h_zeta) * gp_zeta_on_iface;
-#else
-            amrex::Real gpx = dxInv[0] * (pp_arr(i,j,k) - pp_arr(i-1,j,k));
-#endif
-#ifdef ERF_USE_MOISUTRE
-            Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i-1,j,k,PrimQv_comp)
-                            +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i-1,j,k,PrimQc_comp) );
-            rho_u_rhs(i, j, k) -= gpx / (1.0 + q);
-#else
-            rho_u_rhs(i, j, k) -= gpx;
-#endif
-
-            // Add driving pressure gradient
-            if (solverChoice.abl_driver_type == ABLDriverType::PressureGradient)
-                rho_u_rhs(i, j, k) += -solverChoice.abl_pressure_grad[0];
-
-            // Add Coriolis forcing (that assumes east is +x, north is +y)
-            if (solverChoice.use_coriolis)
-            {
-                Real rho_v_loc = 0.25 * (rho_v(i,j+1,k) + rho_v(i,j,k) + rho_v(i-1,j+1,k) + rho_v(i-1,j,k));
-                Real rho_w_loc = 0.25 * (rho_w(i,j,k+1) + rho_w(i,j,k) + rho_w(i,j-1,k+1) + rho_w(i,j-1,k));
-                rho_u_rhs(i, j, k) += solverChoice.coriolis_factor *
-                        (rho_v_loc * solverChoice.sinphi - rho_w_loc * solverChoice.cosphi);
-            }
-
-            // Add geostrophic forcing
-            if (solverChoice.abl_driver_type == ABLDriverType::GeostrophicWind)
-                rho_u_rhs(i, j, k) += solverChoice.abl_geo_forcing[0];
-
-            // Add Rayleigh damping
-            if (solverChoice.use_rayleigh_damping)
-            {
-                Real uu = rho_u(i,j,k) / cell_data(i,j,k,Rho_comp);
-                rho_u_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (uu - dptr_rayleigh_ubar[k]) * cell_data(i,j,k,Rho_comp);
-            }
-
-            } // not on coarse-fine boundary
-        });
-        amrex::ParallelFor(tby,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) { // y-momentum equation
-
-            rho_v_rhs(i, j, k) = 0.0; // Initialize the updated y-mom eqn term to zero
-
-            bool on_coarse_fine_boundary = false;
-            if (level > 0)
-            {
-               on_coarse_fine_boundary =
-                 ( (j == vlo_y && mlo_y(i,j,k)) || (j == vhi_y+1 && mhi_y(i,j,k)) );
-            }
-
-            if (!on_coarse_fine_boundary)
-            {
-
-            // Add advective terms
-            rho_v_rhs(i, j, k) += -AdvectionSrcForYMom(i, j, k, rho_u, rho_v, rho_w, v,
-#ifdef ERF_USE_TERRAIN
-                                                       z_nd, detJ,
-#endif
-                                                       dxInv, l_spatial_order);
-
-            // Add diffusive terms
-            rho_v_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
-                                                     MomentumEqn::y, dxInv, K_turb, solverChoice,
-#ifdef ERF_USE_TERRAIN
-                                                     z_nd, detJ,
-#endif
-                                                     domain, bc_ptr);
+        dispatch_options(l_use_diff, l_use_coriolis, l_use_rayleigh,
+                         [&] (auto diffuse, auto coriolis, auto rayleigh)
+        {
+            constexpr bool Diffuse  = decltype(diffuse)::value;
+            constexpr bool Coriolis = decltype(coriolis)::value;
+            constexpr bool Rayleigh = decltype(rayleigh)::value;
 
-            // Add pressure gradient
+            slow_rhs_for_xmom<Diffuse,Coriolis,Rayleigh>(tbx, level, vlo_x, vhi_x, mlo_x, mhi_x,
+                rho_u_rhs, rho_u, rho_v, rho_w, u, v, w, cell_data, cell_prim, pp_arr,
 #ifdef ERF_USE_TERRAIN
-            Real met_h_xi,met_h_eta,met_h_zeta;
-            ComputeMetricAtJface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_eta_zeta);
-            Real gp_eta = dxInv[1] * (pp_arr(i,j,k) - pp_arr(i,j-1,k));
-            Real gp_zeta_on_jface = (k == 0) ?
-                0.5 * dxInv[2] * (
-                  pp_arr(i,j,k+1) + pp_arr(i,j-1,k+1) - pp_arr(i,j,k) - pp_arr(i,j-1,k)):
-                0.25 * dxInv[2] * (
-                  pp_arr(i,j,k+1) + pp_arr(i,j-1,k+1) - pp_arr(i,j,k-1) - pp_arr(i,j-1,k-1));
-            amrex::Real gpy = gp_eta - (met_h_eta / met_h_zeta) * gp_zeta_on_jface;
+                z_nd, detJ, domain, bc_ptr,
 #else
-            amrex::Real gpy = dxInv[1] * (pp_arr(i,j,k) - pp_arr(i,j-1,k));
+                s_cc, s12, s13, s23,
 #endif
-#ifdef ERF_USE_MOISUTRE
-            Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i,j-1,k,PrimQv_comp)
-                            +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i,j-1,k,PrimQc_comp) );
-            rho_v_rhs(i, j, k) -= gpy / (1.0_rt + q);
-#else
-            rho_v_rhs(i, j, k) -= gpy;
-#endif
-
-            // Add driving pressure gradient
-            if (solverChoice.abl_driver_type == ABLDriverType::PressureGradient)
-                rho_v_rhs(i, j, k) += -solverChoice.abl_pressure_grad[1];
-
-            // Add Coriolis forcing (that assumes east is +x, north is +y)
-            if (solverChoice.use_coriolis)
-            {
-                Real rho_u_loc = 0.25 * (rho_u(i+1,j,k) + rho_u(i,j,k) + rho_u(i+1,j-1,k) + rho_u(i,j-1,k));
-                rho_v_rhs(i, j, k) += -solverChoice.coriolis_factor * rho_u_loc * solverChoice.sinphi;
-            }
-
-            // Add geostrophic forcing
-            if (solverChoice.abl_driver_type == ABLDriverType::GeostrophicWind)
-                rho_v_rhs(i, j, k) += solverChoice.abl_geo_forcing[1];
+                K_turb, dxInv, l_spatial_order, solverChoice, l_forcing,
+                dptr_rayleigh_tau, dptr_rayleigh_ubar);
 
-            // Add Rayleigh damping
-            if (solverChoice.use_rayleigh_damping)
-            {
-                Real vv = rho_v(i,j,k) / cell_data(i,j,k,Rho_comp);
-                rho_v_rhs(i, j, k) -= dptr_rayleigh_tau[k] * (vv - dptr_rayleigh_vbar[k]) * cell_data(i,j,k,Rho_comp);
-            }
-
-            } // not on coarse-fine boundary
-        });
-        amrex::ParallelFor(tbz,
-        [=] AMREX_GPU_DEVICE (int i, int j, int k) { // z-momentum equation
-
-            rho_w_rhs(i, j, k) = 0.0; // Initialize the updated z-mom eqn term to zero
-
-            bool on_coarse_fine_boundary = false;
-            if (level > 0)
-            {
-               on_coarse_fine_boundary =
-                 ( (k == vlo_z && mlo_z(i,j,k)) || (k == vhi_z+1 && mhi_z(i,j,k)) );
-            }
-
-            if (!on_coarse_fine_boundary)
-            {
-
-            // Add advective terms
-            rho_w_rhs(i, j, k) += -AdvectionSrcForZMom(i, j, k, rho_u, rho_v, rho_w, w,
+            slow_rhs_for_ymom<Diffuse,Coriolis,Rayleigh>(tby, level, vlo_y, vhi_y, mlo_y, mhi_y,
+                rho_v_rhs, rho_u, rho_v, rho_w, u, v, w, cell_data, cell_prim, pp_arr,
 #ifdef ERF_USE_TERRAIN
-                                                       z_nd, detJ,
-#endif
-                                                       dxInv, l_spatial_order);
-
-            // Add diffusive terms
-            rho_w_rhs(i, j, k) += DiffusionSrcForMom(i, j, k, u, v, w, cell_data,
-                                                     MomentumEqn::z, dxInv, K_turb, solverChoice,
-#ifdef ERF_USE_TERRAIN
-                                                     z_nd, detJ,
-#endif
-                                                     domain, bc_ptr);
-
-            // Add pressure gradient
-#ifdef ERF_USE_TERRAIN
-            Real met_h_xi,met_h_eta,met_h_zeta;
-            ComputeMetricAtKface(i,j,k,met_h_xi,met_h_eta,met_h_zeta,dxInv,z_nd,TerrainMet::h_zeta);
-            amrex::Real gpz = dxInv[2] * (pp_arr(i,j,k) - pp_arr(i,j,k-1)) / met_h_zeta;
+                z_nd, detJ, domain, bc_ptr,
 #else
-            amrex::Real gpz = dxInv[2] * (pp_arr(i,j,k) - pp_arr(i,j,k-1));
-#endif
-#ifdef ERF_USE_MOISUTRE
-            Real q = 0.5 * ( cell_prim(i,j,k,PrimQv_comp) + cell_prim(i,j,k-1,PrimQv_comp)
-                            +cell_prim(i,j,k,PrimQc_comp) + cell_prim(i,j,k-1,PrimQc_comp) );
-            rho_w_rhs(i, j, k) -= gpz / (1.0_rt + q);
-#else
-            rho_w_rhs(i, j, k) -= gpz;
+                s_cc, s12, s13, s23,
 #endif
+                K_turb, dxInv, l_spatial_order, solverChoice, l_forcing,
+                dptr_rayleigh_tau, dptr_rayleigh_vbar);
 
-            // Add gravity term
-            if (solverChoice.use_gravity)
-            {
-                int local_spatial_order = 2;
-                rho_w_rhs(i, j, k) += grav_gpu[2] *
+            slow_rhs_for_zmom<Diffuse,Coriolis,Rayleigh>(tbz, level, vlo_z, vhi_z, mlo_z, mhi_z, domhi_z,
+                rho_w_rhs, rho_u, rho_v, rho_w, u, v, w, cell_data, cell_prim, pp_arr,
 #ifdef ERF_USE_TERRAIN
-                     InterpolateDensityPertFromCellToFace(i, j, k, cell_data, rho_w(i,j,k),
-                                                          Coord::z, local_spatial_order, r0_arr);
+                z_nd, detJ, domain, bc_ptr, r0_arr,
 #else
-                     InterpolateDensityPertFromCellToFace(i, j, k, cell_data, rho_w(i,j,k),
-                                                          Coord::z, local_spatial_order, dptr_dens_hse);
+                s_cc, s12, s13, s23, dptr_dens_hse,
 #endif
-            }
-
-            // Add driving pressure gradient
-            if (solverChoice.abl_driver_type == ABLDriverType::PressureGradient)
-                rho_w_rhs(i, j, k) += -solverChoice.abl_pressure_grad[2];
-
-            // Add Coriolis forcing (that assumes east is +x, north is +y)
-            if (solverChoice.use_coriolis)
-            {
-                Real rho_u_loc = 0.25 * (rho_u(i+1,j,k) + rho_u(i,j,k) + rho_u(i+1,j,k-1) + rho_u(i,j,k-1));
-                rho_w_rhs(i, j, k) += solverChoice.coriolis_factor * rho_u_loc * solverChoice.cosphi;
-            }
-
-            // Add geostrophic forcing
-            if (solverChoice.abl_driver_type == ABLDriverType::GeostrophicWind)
-                rho_w_rhs(i, j, k) += solverChoice.abl_geo_forcing[2];
-
-            // Add Rayleigh damping
-            if (solverChoice.use_rayleigh_damping)
-            {
-                rho_w_rhs(i, j, k) -= dptr_rayleigh_tau[k] * rho_w(i,j,k);
-            }
-
-            // Enforce no forcing term at bottom boundary
-            if (k == 0) {
-                rho_w_rhs(i,j,k) = 0.;
-            } else if (k == domhi_z+1) {
-                //rho_w_rhs(i, j, k) = rho_w_rhs(i,j,k-1);
-                rho_w_rhs(i, j, k) = 0.;
-            }
-
-            } // not on coarse-fine boundary
+                K_turb, dxInv, l_spatial_order, solverChoice, l_forcing,
+                dptr_rayleigh_tau);
         });
         } // not (rhs_vars == RHSVar::slow)
     }
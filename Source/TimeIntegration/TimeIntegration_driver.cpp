@@ -39,7 +39,24 @@ void ERF::erf_advance(int level,
 
     // **************************************************************************************
     // Temporary array that we use to store primitive advected quantities for the RHS
+    // We only fill the components that the RHS reads: KE is only used by the Deardorff model
+    //     and QKE only when it is advected, so we skip them otherwise
     // **************************************************************************************
+#ifndef ERF_NO_TKE
+    const bool need_prim_KE  = (solverChoice.les_type == LESType::Deardorff);
+    const bool need_prim_QKE = (solverChoice.use_QKE && solverChoice.advect_QKE);
+#endif
+
+    amrex::GpuArray<int,NUM_PRIM> prim_comps;
+    int num_prim_comps = 0;
+    for (int n = 0; n < NUM_PRIM; ++n) {
+#ifndef ERF_NO_TKE
+        if (n == PrimKE_comp  && !need_prim_KE ) continue;
+        if (n == PrimQKE_comp && !need_prim_QKE) continue;
+#endif
+        prim_comps[num_prim_comps++] = n;
+    }
+
     auto cons_to_prim = [&](const MultiFab& cons_state, MultiFab& prim_state) {
 #ifdef _OPENMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
@@ -50,7 +67,8 @@ void ERF::erf_advance(int level,
           const Array4<Real>& prim_arr = prim_state.array(mfi);
 
           amrex::ParallelFor(gbx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
-            for (int n = 0; n < NUM_PRIM; ++n) {
+            for (int m = 0; m < num_prim_comps; ++m) {
+              const int n = prim_comps[m];
               prim_arr(i,j,k,PrimTheta_comp + n) = cons_arr(i,j,k,RhoTheta_comp + n) / cons_arr(i,j,k,Rho_comp);
             }
           });
@@ -61,26 +79,33 @@ void ERF::erf_advance(int level,
 
     // **************************************************************************************
     // These are temporary arrays that we use to store the accumulation of the fluxes
+    // The fluxes of all variables are only needed if we reflux; otherwise we only keep
+    //     the mass flux (which the MRI integrator uses for the time-averaged momenta)
+    //     and don't store the diffusive fluxes at all
     // **************************************************************************************
+    const bool store_fluxes = (do_reflux && finest_level > 0);
+    const int nflux = store_fluxes ? nvars : 1;
+
     std::array< MultiFab, AMREX_SPACEDIM >  advflux;
     std::array< MultiFab, AMREX_SPACEDIM > diffflux;
 
-     advflux[0].define(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
-    diffflux[0].define(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
-
-     advflux[1].define(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
-    diffflux[1].define(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
-
-     advflux[2].define(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
-    diffflux[2].define(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
+     advflux[0].define(convert(ba,IntVect(1,0,0)), dm, nflux, 0);
+     advflux[1].define(convert(ba,IntVect(0,1,0)), dm, nflux, 0);
+     advflux[2].define(convert(ba,IntVect(0,0,1)), dm, nflux, 0);
 
      advflux[0].setVal(0.);
      advflux[1].setVal(0.);
      advflux[2].setVal(0.);
 
-    diffflux[0].setVal(0.);
-    diffflux[1].setVal(0.);
-    diffflux[2].setVal(0.);
+    if (store_fluxes) {
+        diffflux[0].define(convert(ba,IntVect(1,0,0)), dm, nvars, 0);
+        diffflux[1].define(convert(ba,IntVect(0,1,0)), dm, nvars, 0);
+        diffflux[2].define(convert(ba,IntVect(0,0,1)), dm, nvars, 0);
+
+        diffflux[0].setVal(0.);
+        diffflux[1].setVal(0.);
+        diffflux[2].setVal(0.);
+    }
 
     // **************************************************************************************
     // Here we define state_old and state_new which are to be advanced
@@ -91,9 +116,9 @@ void ERF::erf_advance(int level,
     state_old.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, 1, xvel_old.nGrow())); // xmom
     state_old.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, 1, yvel_old.nGrow())); // ymom
     state_old.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, 1, zvel_old.nGrow())); // zmom
-    state_old.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, nvars, 1)); // x-fluxes
-    state_old.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, nvars, 1)); // y-fluxes
-    state_old.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, nvars, 1)); // z-fluxes
+    state_old.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, nflux, 1)); // x-fluxes
+    state_old.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, nflux, 1)); // y-fluxes
+    state_old.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, nflux, 1)); // z-fluxes
 
     // Final solution
     amrex::Vector<amrex::MultiFab> state_new;
@@ -101,9 +126,9 @@ void ERF::erf_advance(int level,
     state_new.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, 1, xvel_old.nGrow())); // xmom
     state_new.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, 1, yvel_old.nGrow())); // ymom
     state_new.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, 1, zvel_old.nGrow())); // zmom
-    state_new.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, nvars, 1)); // x-fluxes
-    state_new.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, nvars, 1)); // y-fluxes
-    state_new.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, nvars, 1)); // z-fluxes
+    state_new.push_back(MultiFab(convert(ba,IntVect(1,0,0)), dm, nflux, 1)); // x-fluxes
+    state_new.push_back(MultiFab(convert(ba,IntVect(0,1,0)), dm, nflux, 1)); // y-fluxes
+    state_new.push_back(MultiFab(convert(ba,IntVect(0,0,1)), dm, nflux, 1)); // z-fluxes
 
     // ***********************************************************************************************
     // Prepare the old-time data for calling the integrator
@@ -179,16 +204,31 @@ void ERF::erf_advance(int level,
         // ***************************************************************************************
         FillIntermediatePatch(level, time_for_fp, {S_data[IntVar::cons], xvel_new, yvel_new, zvel_new});
 
-        // Now we can convert back to momentum on valid+ghost since we have
-        //     filled the ghost regions for both velocity and density
-        VelocityToMomentum(xvel_new, yvel_new, zvel_new,
-                           S_data[IntVar::cons],
-                           S_data[IntVar::xmom],
-                           S_data[IntVar::ymom],
-                           S_data[IntVar::zmom],
-                           xvel_new.nGrowVect());
+        // Now we can convert back to momentum since we have filled the ghost regions for both
+        //     velocity and density. The momenta are the variables we advance, so we only
+        //     convert where the fill may have changed the velocity (the ghost faces and the
+        //     faces on the domain boundary) rather than round-tripping the valid momenta
+        VelocityToMomentumOnFilledFaces(xvel_new, yvel_new, zvel_new,
+                                        S_data[IntVar::cons],
+                                        S_data[IntVar::xmom],
+                                        S_data[IntVar::ymom],
+                                        S_data[IntVar::zmom],
+                                        xvel_new.nGrowVect(), fine_geom.Domain());
     };
 
+    // The eddy viscosity is computed once for each stage state: post_update marks the start
+    //     of a new stage, and the first call of erf_slow_rhs after it fills eddyDiffs_lev[level]
+    //     for the later calls to reuse. The MOST fill in FillIntermediatePatch uses the same
+    //     storage for the closure of the state before its ghost values are imposed, and marks
+    //     it invalid again. The MRI call of the slow RHS for the slow variables sees the state
+    //     after the fast substeps rather than the stage state, so it always recomputes it.
+    //     The strain rates are cached the same way, but only erf_slow_rhs uses them
+    MultiFab* eddyDiffs = get_eddy_diffs_storage(level);
+    eddyDiffs_valid[level] = 0;
+    Vector<MultiFab>* strain = get_strain_storage(level);
+    strain_valid[level] = 0;
+    MYNNColumns* mynn_columns = get_mynn_columns(level, grids[level], dmap[level]);
+
     apply_bcs(state_old, old_time);
     cons_to_prim(state_old[IntVar::cons], S_prim);
 
@@ -202,6 +242,8 @@ void ERF::erf_advance(int level,
         erf_slow_rhs(level, S_rhs, S_data, S_prim, S_scratch,
                      xvel_new, yvel_new, zvel_new,
                      source, advflux, diffflux,
+                     eddyDiffs, !eddyDiffs_valid[level],
+                     strain, strain_valid[level], mynn_columns,
                      fine_geom, ifr, solverChoice,
                      m_most, domain_bcs_type_d,
 #ifdef ERF_USE_TERRAIN
@@ -213,6 +255,7 @@ void ERF::erf_advance(int level,
                      dptr_rayleigh_tau, dptr_rayleigh_ubar,
                      dptr_rayleigh_vbar, dptr_rayleigh_thetabar,
                      rhs_vars);
+        if (eddyDiffs) eddyDiffs_valid[level] = 1;
     };
 
     //Create function lambdas
@@ -222,9 +265,12 @@ void ERF::erf_advance(int level,
                             const Real time,
                             const int rhs_vars=RHSVar::all) {
         if (verbose) Print() << "Calling slow rhs, time = " << time << std::endl;
+        if (rhs_vars == RHSVar::slow) strain_valid[level] = 0;
         erf_slow_rhs(level, S_rhs, S_data, S_prim, S_scratch,
                      xvel_new, yvel_new, zvel_new,
                      source, advflux, diffflux,
+                     eddyDiffs, (!eddyDiffs_valid[level] || rhs_vars == RHSVar::slow),
+                     strain, strain_valid[level], mynn_columns,
                      fine_geom, ifr, solverChoice, m_most, domain_bcs_type_d,
 #ifdef ERF_USE_TERRAIN
                      z_phys_nd[level], detJ_cc[level],
@@ -235,6 +281,7 @@ void ERF::erf_advance(int level,
                      dptr_rayleigh_tau, dptr_rayleigh_ubar,
                      dptr_rayleigh_vbar, dptr_rayleigh_thetabar,
                      rhs_vars);
+        if (eddyDiffs) eddyDiffs_valid[level] = 1;
     };
 
     auto fast_rhs_fun = [&](      Vector<MultiFab>& S_rhs,
@@ -257,6 +304,8 @@ void ERF::erf_advance(int level,
 
     auto post_update_fun = [&](Vector<MultiFab>& S_data, const Real time_for_fp)
     {
+        eddyDiffs_valid[level] = 0;
+        strain_valid[level] = 0;
         apply_bcs(S_data, time_for_fp);
         cons_to_prim(S_data[IntVar::cons], S_prim);
     };
@@ -272,7 +321,10 @@ void ERF::erf_advance(int level,
     // Setup the integrator
     // **************************************************************************************
     if (use_native_mri) {
+      // Measure the fab memory taken by the integrator's storage (summed over ranks)
+      const Long fab_bytes_before = TotalBytesAllocatedInFabs();
       MRISplitIntegrator<Vector<MultiFab> > lev_integrator(state_old);
+      Long fab_bytes[2] = {TotalBytesAllocatedInFabs() - fab_bytes_before, TotalBytesAllocatedInFabs()};
 
       // define rhs and 'post update' utility function that is called after calculating
       // any state data (e.g. at RK stages or at the end of a timestep)
@@ -286,6 +338,18 @@ void ERF::erf_advance(int level,
       // Integrate for a single timestep
       // **************************************************************************************
       lev_integrator.advance(state_old, state_new, old_time, dt_advance);
+
+      if (verbose) {
+          // The high-water mark includes the temporaries of the advance; it is per rank, so we
+          //     report the largest
+          Long fab_bytes_hwm = TotalBytesAllocatedInFabsHWM();
+          ParallelDescriptor::ReduceLongSum(fab_bytes, 2);
+          ParallelDescriptor::ReduceLongMax(fab_bytes_hwm);
+          Print() << "MRI integrator storage at level " << level << ": " << fab_bytes[0]
+                  << " bytes; fabs in use after its construction: " << fab_bytes[1]
+                  << " bytes; fab high-water mark (largest over ranks): " << fab_bytes_hwm
+                  << " bytes" << std::endl;
+      }
     } else {
       TimeIntegrator<Vector<MultiFab> > lev_integrator(state_old);
 
@@ -328,3 +392,69 @@ void ERF::erf_advance(int level,
     amrex::Real new_time = old_time + dt_advance;
     FillIntermediatePatch(level, new_time, {cons_new, xvel_new, yvel_new, zvel_new});
 }
+
+amrex::MultiFab*
+ERF::get_eddy_diffs_storage (int lev)
+{
+    if ( (solverChoice.les_type == LESType::None) &&
+         (solverChoice.pbl_type == PBLType::None) && !solverChoice.use_QKE ) {
+        return nullptr;
+    }
+
+    const BoxArray& ba            = grids[lev];
+    const DistributionMapping& dm = dmap[lev];
+    if (!eddyDiffs_lev[lev] ||
+        eddyDiffs_lev[lev]->boxArray()       != ba ||
+        eddyDiffs_lev[lev]->DistributionMap() != dm)
+    {
+        // The MOST fill reads up to three ghost cells of it, erf_slow_rhs only one
+        eddyDiffs_lev[lev] = std::make_unique<MultiFab>(ba, dm, EddyDiff::NumDiffs, 3);
+        eddyDiffs_valid[lev] = 0;
+    }
+    return eddyDiffs_lev[lev].get();
+}
+
+MYNNColumns*
+ERF::get_mynn_columns (int lev, const BoxArray& ba, const DistributionMapping& dm)
+{
+    if (solverChoice.pbl_type != PBLType::MYNN25) return nullptr;
+
+    // RemakeLevel fills the new grids before they become the level's grids
+    auto& mynn_columns = mynn_columns_lev[lev];
+    if (!mynn_columns || mynn_columns->ba != ba || mynn_columns->dm != dm) {
+        mynn_columns = std::make_unique<MYNNColumns>(ba, dm, geom[lev]);
+    }
+    return mynn_columns.get();
+}
+
+amrex::Vector<amrex::MultiFab>*
+ERF::get_strain_storage (int lev)
+{
+#ifdef ERF_USE_TERRAIN
+    amrex::ignore_unused(lev);
+    return nullptr;
+#else
+    if ( (solverChoice.molec_diff_type == MolecDiffType::None) &&
+         (solverChoice.les_type        ==       LESType::None) &&
+         (solverChoice.pbl_type        ==       PBLType::None) ) {
+        return nullptr;
+    }
+
+    const BoxArray& ba            = grids[lev];
+    const DistributionMapping& dm = dmap[lev];
+    Vector<MultiFab>& strain = strain_lev[lev];
+    if (strain.empty() ||
+        strain[Strain::cc].boxArray()       != ba ||
+        strain[Strain::cc].DistributionMap() != dm)
+    {
+        strain.clear();
+        strain.resize(Strain::NumTypes);
+        strain[Strain::cc].define(ba, dm, Strain::NumCCComps, 1);
+        strain[Strain::xy].define(convert(ba,IntVect(1,1,0)), dm, 1, 1);
+        strain[Strain::xz].define(convert(ba,IntVect(1,0,1)), dm, 1, 1);
+        strain[Strain::yz].define(convert(ba,IntVect(0,1,1)), dm, 1, 1);
+        strain_valid[lev] = 0;
+    }
+    return &strain;
+#endif
+}
@@ -48,6 +48,20 @@ int main(int argc, char* argv[])
     }
     amrex::Initialize(argc,argv,true,MPI_COMM_WORLD,add_par);
 
+    // If asked to, convert a compressed plotfile into a native AMReX plotfile and quit
+    {
+        ParmParse pp("erf");
+        std::string compressed_plotfile;
+        if (pp.query("convert_compressed_plotfile", compressed_plotfile)) {
+            std::string native_plotfile = compressed_plotfile + "_native";
+            pp.query("converted_plotfile", native_plotfile);
+            amrex::Print() << "Converting " << compressed_plotfile << " into " << native_plotfile << '\n';
+            PlotCompress::ConvertCompressedPlotfile(compressed_plotfile, native_plotfile);
+            amrex::Finalize();
+            return 0;
+        }
+    }
+
     // Save the inputs file name for later.
     if (!strchr(argv[1], '=')) {
       inputs_name = argv[1];
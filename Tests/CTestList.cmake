@@ -97,10 +97,36 @@ function(add_test_r TEST_NAME TEST_EXE PLTFILE)
     )
 endfunction(add_test_r)
 
-# Standard unit test
+# Compressed plotfile test: rerun a regression input writing lossy compressed plotfiles,
+#     which are read back and checked against the error bound (the run aborts on failure),
+#     then convert the last one into a native plotfile and compare it with the gold file
+function(add_test_c TEST_NAME TEST_EXE PLTFILE)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(TEST_NAME_RUNTIME ${TEST_NAME}_compressed)
+    set(RUNTIME_OPTIONS "erf.plotfile_type=compressed amr.plot_file=pltc amr.compress_verify=1 amr.compress_rel_tol=1.e-4")
+    string(REPLACE "plt" "pltc" PLTCFILE ${PLTFILE})
+    set(CONVERT_OPTIONS "erf.convert_compressed_plotfile=${CURRENT_TEST_BINARY_DIR}/${PLTCFILE} erf.converted_plotfile=${CURRENT_TEST_BINARY_DIR}/${PLTCFILE}_native")
+    set(FCOMPARE_FLAGS "-a -r 1e-3")
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i ${RUNTIME_OPTIONS} > ${TEST_NAME_RUNTIME}.log && ${MPI_COMMANDS} ${TEST_EXE} ${CONVERT_OPTIONS} >> ${TEST_NAME_RUNTIME}.log && ${FCOMPARE_EXE} ${FCOMPARE_FLAGS} ${PLOT_GOLD} ${CURRENT_TEST_BINARY_DIR}/${PLTCFILE}_native")
+
+    add_test(${TEST_NAME_RUNTIME} ${test_command})
+    set_tests_properties(${TEST_NAME_RUNTIME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "compression"
+        ATTACHED_FILES_ON_FAIL "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME_RUNTIME}.log"
+    )
+endfunction(add_test_c)
+
+# Standard unit test: run one of the tests built into the erf_unit_tests executable
+#     (the output, including any timings, is shown by ctest -V)
 function(add_test_u TEST_NAME)
     setup_test()
-    add_test(${TEST_NAME} sh -c "${MPI_COMMANDS} ${CMAKE_BINARY_DIR}/${amr_wind_unit_test_exe_name}")
+    add_test(${TEST_NAME} sh -c "${MPI_COMMANDS} ${ERF_UNIT_TEST_EXE} unit_test.name=${TEST_NAME}")
     set_tests_properties(${TEST_NAME}
         PROPERTIES
         TIMEOUT 500
@@ -110,10 +136,58 @@ function(add_test_u TEST_NAME)
     )
 endfunction(add_test_u)
 
+# Unit test run on a single rank with each of the given numbers of OpenMP threads,
+#     to show how the timings it prints scale with the threads
+function(add_test_u_threads TEST_NAME)
+    setup_test()
+    foreach(NTHREADS ${ARGN})
+        set(TEST_NAME_THREADS ${TEST_NAME}_omp${NTHREADS})
+        add_test(${TEST_NAME_THREADS} sh -c "${ERF_UNIT_TEST_EXE} unit_test.name=${TEST_NAME}")
+        set_tests_properties(${TEST_NAME_THREADS}
+            PROPERTIES
+            TIMEOUT 500
+            PROCESSORS ${NTHREADS}
+            ENVIRONMENT "OMP_NUM_THREADS=${NTHREADS}"
+            WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+            LABELS "unit;threads"
+        )
+    endforeach()
+endfunction(add_test_u_threads)
+
+# Performance test: time a few steps of an input that writes no output; the log shows the
+#     total run time and, when built with ERF_ENABLE_TINY_PROFILE, the time in each kernel
+function(add_test_p TEST_NAME TEST_EXE)
+    setup_test()
+
+    set(TEST_EXE ${CMAKE_BINARY_DIR}/Exec/${TEST_EXE})
+    set(test_command sh -c "${MPI_COMMANDS} ${TEST_EXE} ${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.i > ${TEST_NAME}.log && grep -E 'Total Time|erf_slow_rhs|erf_fast_rhs' ${TEST_NAME}.log")
+
+    add_test(${TEST_NAME} ${test_command})
+    set_tests_properties(${TEST_NAME}
+        PROPERTIES
+        TIMEOUT 5400
+        PROCESSORS ${NP}
+        WORKING_DIRECTORY "${CURRENT_TEST_BINARY_DIR}/"
+        LABELS "performance"
+        ATTACHED_FILES "${CURRENT_TEST_BINARY_DIR}/${TEST_NAME}.log"
+    )
+endfunction(add_test_p)
+
 #=============================================================================
 # Unit tests
 #=============================================================================
-# add_test_u(unit_tests)
+if(ERF_ENABLE_OPENMP)
+add_test_u_threads(plane_average 1 2 4 8 16)
+else()
+add_test_u(plane_average)
+endif()
+add_test_u(eos_pow)
+if(ERF_ENABLE_TKE)
+add_test_u(mynn)
+endif()
+if(ERF_ENABLE_NETCDF)
+add_test_u(nc_to_fab)
+endif()
 
 #=============================================================================
 # Regression tests
@@ -138,6 +212,15 @@ add_test_r(EkmanSpiral "EkmanSpiral/ekman_spiral" "plt00010")
 add_test_r(DensityCurrent "DensityCurrent/density_current" "plt00010")
 
 #=============================================================================
-# Performance tests
+# Compressed plotfile tests
 #=============================================================================
+add_test_c(ScalarAdvectionUniformU          "ScalarAdvDiff/erf_scalar_advdiff" "plt00020")
+add_test_c(TaylorGreenAdvecting             "TaylorGreenVortex/taylor_green" "plt00010")
+add_test_c(DensityCurrent                   "DensityCurrent/density_current" "plt00010")
 
+#=============================================================================
+# Performance tests
+#=============================================================================
+add_test_p(ABL_DNS_perf                     "ABL/erf_abl")
+add_test_p(ABL_Smagorinsky_perf             "ABL/erf_abl")
+add_test_p(ABL_Deardorff_perf               "ABL/erf_abl")
@@ -0,0 +1,49 @@
+#include <functional>
+#include <map>
+#include <string>
+
+#include <AMReX.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+#include <AMReX_Print.H>
+
+#include "UnitTests.H"
+
+using namespace amrex;
+
+int main (int argc, char* argv[])
+{
+    amrex::Initialize(argc,argv);
+
+    bool passed = true;
+    {
+        const std::map<std::string, std::function<bool()>> tests = {
+            {"plane_average", test_plane_average},
+            {"eos_pow", test_eos_pow},
+#ifndef ERF_NO_TKE
+            {"mynn", test_mynn},
+#endif
+#ifdef ERF_USE_NETCDF
+            {"nc_to_fab", test_nc_to_fab},
+#endif
+        };
+
+        ParmParse pp("unit_test");
+        std::string name;
+        pp.get("name", name);
+
+        auto it = tests.find(name);
+        if (it == tests.end()) {
+            amrex::Abort("Unknown (or not built) unit test: " + name);
+        }
+
+        amrex::Print() << "Running unit test " << name << std::endl;
+        passed = it->second();
+        ParallelDescriptor::ReduceBoolAnd(passed);
+        amrex::Print() << "Unit test " << name << (passed ? " PASSED" : " FAILED") << std::endl;
+    }
+
+    amrex::Finalize();
+
+    return passed ? 0 : 1;
+}
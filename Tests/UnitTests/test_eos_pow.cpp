@@ -0,0 +1,69 @@
+#include <cmath>
+#include <limits>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include "EOSPowSweep.H"
+#include "UnitTests.H"
+
+using namespace amrex;
+
+bool
+test_eos_pow ()
+{
+    ParmParse pp("unit_test");
+    int npts = 1 << 20;
+    pp.query("npts", npts);
+    int nrep = 20;
+    pp.query("nrep", nrep);
+
+    // Log-uniform over [1e-10, 1e10], which covers every argument of eos_pow in EOS.H,
+    //     plus the ends of the range and the edges of the mantissa reduction
+    Vector<Real> x(npts);
+    for (int n = 0; n < npts; ++n) {
+        x[n] = std::pow(10.0, -10.0 + 20.0 * n / (npts - 1));
+    }
+    x.push_back(1.0);
+    x.push_back(std::sqrt(0.5));
+    x.push_back(std::nextafter(std::sqrt(0.5), 0.0));
+    x.push_back(std::sqrt(2.0));
+    x.push_back(std::nextafter(std::sqrt(2.0), 0.0));
+
+    // Values of R_d*rho*theta/p_0 in the atmosphere, for the timings
+    Vector<Real> x_atm(npts);
+    for (int n = 0; n < npts; ++n) {
+        x_atm[n] = 0.2 + 1.1 * n / (npts - 1);
+    }
+
+    // The exponents used in EOS.H
+    const Real exponents[] = {Gamma, Gamma - 1.0, 1.0 / Gamma, R_d / c_p, Gamma * R_d / c_p};
+
+    // In single precision the result is rounded to float on return
+    const double tol = std::max(1.e-13, 4.0 * static_cast<double>(std::numeric_limits<Real>::epsilon()));
+
+    bool passed = true;
+    Vector<Real> y;
+    amrex::Print() << "  " << x.size() << " points in [1e-10, 1e10], timings over "
+                   << nrep << " x " << npts << " points in [0.2, 1.3]\n";
+    for (const Real a : exponents)
+    {
+        const EOSPowSweep sweep = eos_pow_sweep(x, a, y, 1);
+        const EOSPowSweep timed = eos_pow_sweep(x_atm, a, y, nrep);
+#ifdef ERF_UNIT_TEST_FAST_MATH
+        const double err_fast_math = eos_pow_max_rel_err_fast_math(x, a);
+#else
+        const double err_fast_math = 0.0;
+#endif
+        amrex::Print() << "  a = " << a << ": max rel err " << sweep.max_rel_err
+#ifdef ERF_UNIT_TEST_FAST_MATH
+                       << " (-ffast-math: " << err_fast_math << ")"
+#endif
+                       << ", eos_pow " << timed.t_eos_pow << " s, std::pow " << timed.t_std_pow
+                       << " s (speedup " << timed.t_std_pow / timed.t_eos_pow << ")\n";
+        passed = passed && sweep.max_rel_err <= tol && timed.max_rel_err <= tol && err_fast_math <= tol;
+    }
+    amrex::Print() << "  tolerance " << tol << std::endl;
+
+    return passed;
+}
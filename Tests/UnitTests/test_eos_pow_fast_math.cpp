@@ -0,0 +1,15 @@
+#include "EOSPowSweep.H"
+#include "UnitTests.H"
+
+// Built with -ffast-math (see CMakeLists.txt); eos_pow is inlined here, so this is the
+//     __FAST_MATH__ path of eos_pow
+#ifndef __FAST_MATH__
+#error "test_eos_pow_fast_math.cpp must be built with -ffast-math"
+#endif
+
+double
+eos_pow_max_rel_err_fast_math (const amrex::Vector<amrex::Real>& x, const amrex::Real a)
+{
+    amrex::Vector<amrex::Real> y;
+    return eos_pow_sweep(x, a, y, 1).max_rel_err;
+}
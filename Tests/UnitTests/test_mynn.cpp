@@ -0,0 +1,308 @@
+#include <cmath>
+#include <limits>
+#include <memory>
+
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+
+#include "DataStruct.H"
+#include "PBLModels.H"
+#include "UnitTests.H"
+
+using namespace amrex;
+
+// The previous implementation: the column integrals are summed with atomics into FABs
+//     allocated for each tile, so every (grown) tile must span the whole vertical domain
+static void
+mynn_viscosity_per_tile (const MultiFab& xvel, const MultiFab& yvel, const MultiFab& cons_in,
+                         MultiFab& eddyViscosity, const Geometry& geom,
+                         const SolverChoice& solverChoice, std::unique_ptr<ABLMost>& most)
+{
+    const Real A1 = solverChoice.pbl_A1;
+    const Real A2 = solverChoice.pbl_A2;
+    const Real B2 = solverChoice.pbl_B2;
+    const Real C1 = solverChoice.pbl_C1;
+    const Real C2 = solverChoice.pbl_C2;
+    const Real C3 = solverChoice.pbl_C3;
+    const Real C5 = solverChoice.pbl_C5;
+
+#ifdef _OPENMP
+#pragma omp parallel if (Gpu::notInLaunchRegion())
+#endif
+    for (MFIter mfi(eddyViscosity,TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+
+      const Box &bx = mfi.growntilebox(1);
+      const Array4<Real const > &cell_data = cons_in.array(mfi);
+      const Array4<Real> &K_turb = eddyViscosity.array(mfi);
+      const Array4<Real const> &uvel = xvel.array(mfi);
+      const Array4<Real const> &vvel = yvel.array(mfi);
+
+      const Box &dbx = geom.Domain();
+      Box sbx(bx.smallEnd(), bx.bigEnd());
+      sbx.grow(2,-1);
+      AMREX_ALWAYS_ASSERT(sbx.smallEnd(2) == dbx.smallEnd(2) && sbx.bigEnd(2) == dbx.bigEnd(2));
+
+      const GeometryData gdata = geom.data();
+
+      const Box xybx = PerpendicularBox<ZDir>(bx, IntVect{0,0,0});
+      FArrayBox qintegral(xybx,2);
+      qintegral.setVal<RunOn::Device>(0.0);
+      FArrayBox qturb(bx,1);
+      const Array4<Real> qint = qintegral.array();
+      const Array4<Real> qvel= qturb.array();
+
+      ParallelFor(Gpu::KernelInfo().setReduction(true), bx,
+                  [=] AMREX_GPU_DEVICE (int i, int j, int k, Gpu::Handler const& handler) noexcept
+      {
+          const Real Zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+          const Real rho = cell_data(i,j,k,Rho_comp);
+          qvel(i,j,k) = std::sqrt(cell_data(i,j,k,RhoQKE_comp) / rho);
+          if (sbx.contains(i,j,k)) {
+              Gpu::deviceReduceSum(&qint(i,j,0,0), Zval*qvel(i,j,k), handler);
+              Gpu::deviceReduceSum(&qint(i,j,0,1), qvel(i,j,k), handler);
+          }
+      });
+
+      Real dz_inv = geom.InvCellSize(2);
+      int izmin = geom.Domain().smallEnd(2);
+      int izmax = geom.Domain().bigEnd(2);
+      const Real l_obukhov = most->obukhov_len;
+      const Real surface_heat_flux = most->surf_temp_flux;
+      const Real theta0 = most->theta_mean;
+      ParallelFor(bx, [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept
+      {
+          Real dthetadz, dudz, dvdz;
+          if (k == izmax) {
+              dthetadz = (cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp) -
+                          cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+              dudz = 0.5*(uvel(i,j,k) - uvel(i,j,k-1) + uvel(i+1,j,k) - uvel(i+1,j,k-1))*dz_inv;
+              dvdz = 0.5*(vvel(i,j,k) - vvel(i,j,k-1) + vvel(i,j+1,k) - vvel(i,j+1,k-1))*dz_inv;
+          } else if (k == izmin){
+              dthetadz = (cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                          cell_data(i,j,k,RhoTheta_comp)/cell_data(i,j,k,Rho_comp))*dz_inv;
+              dudz = 0.5*(uvel(i,j,k+1) - uvel(i,j,k) + uvel(i+1,j,k+1) - uvel(i+1,j,k))*dz_inv;
+              dvdz = 0.5*(vvel(i,j,k+1) - vvel(i,j,k) + vvel(i,j+1,k+1) - vvel(i,j+1,k))*dz_inv;
+          } else {
+              dthetadz = 0.5*(cell_data(i,j,k+1,RhoTheta_comp)/cell_data(i,j,k+1,Rho_comp) -
+                              cell_data(i,j,k-1,RhoTheta_comp)/cell_data(i,j,k-1,Rho_comp))*dz_inv;
+              dudz = 0.25*(uvel(i,j,k+1) - uvel(i,j,k-1) + uvel(i+1,j,k+1) - uvel(i+1,j,k-1))*dz_inv;
+              dvdz = 0.25*(vvel(i,j,k+1) - vvel(i,j,k-1) + vvel(i,j+1,k+1) - vvel(i,j+1,k-1))*dz_inv;
+          }
+
+          const Real zval = gdata.ProbLo(2) + (k + 0.5)*gdata.CellSize(2);
+          const Real zeta = zval/l_obukhov;
+          Real l_S;
+          if (zeta >= 1.0) {
+              l_S = KAPPA*zval/3.7;
+          } else if (zeta >= 0) {
+              l_S = KAPPA*zval/(1+2.7*zeta);
+          } else {
+              l_S = KAPPA*zval*std::pow(1.0 - 100.0 * zeta, 0.2);
+          }
+
+          Real l_T;
+          if (qint(i,j,0,1) > 0.0) {
+              l_T = 0.23*qint(i,j,0,0)/qint(i,j,0,1);
+          } else {
+              l_T = std::numeric_limits<Real>::max();
+          }
+
+          Real l_B;
+          if (dthetadz > 0) {
+              Real N_brunt_vaisala = CONST_GRAV/theta0 * std::sqrt(dthetadz);
+              if (zeta < 0) {
+                  Real qc = CONST_GRAV/theta0 * surface_heat_flux * l_T;
+                  qc = std::pow(qc,1.0/3.0);
+                  l_B = (1.0 + 5.0*std::sqrt(qc/(N_brunt_vaisala * l_T))) * qvel(i,j,k)/N_brunt_vaisala;
+              } else {
+                  l_B = qvel(i,j,k) / N_brunt_vaisala;
+              }
+          } else {
+              l_B = std::numeric_limits<Real>::max();
+          }
+
+          Real l_comb = 1.0 / (1.0/l_S + 1.0/l_T + 1.0/l_B);
+
+          Real l2_over_q2 = l_comb*l_comb/(qvel(i,j,k)*qvel(i,j,k));
+          Real GM = l2_over_q2 * (dudz*dudz + dvdz*dvdz);
+          Real GH = -l2_over_q2 / theta0 * dthetadz;
+          Real E1 = 1.0 + 6.0*A1*A1*GM - 9.0*A1*A2*(1.0-C2)*GH;
+          Real E2 = -3.0*A1*(4.0*A1 + 3.0*A2*(1.0-C5))*(1.0-C2)*GH;
+          Real E3 = 6.0*A2*A1*GM;
+          Real E4 = 1.0 - 12.0*A2*A1*(1.0-C2)*GH -3.0*A2*B2*(1.0-C3)*GH;
+          Real R1 = A1*(1.0-3.0*C1);
+
+          Real SM = (A2*E2 - R1*E4)/(E2*E3 - E1*E4);
+          Real SH = (R1*E3 - A2*E1)/(E2*E3 - E1*E4);
+          Real SQ = 3.0 * SM;
+
+          const Real rho = cell_data(i,j,k,Rho_comp);
+          K_turb(i,j,k,EddyDiff::Mom_v)   = rho * l_comb * qvel(i,j,k) * SM;
+          K_turb(i,j,k,EddyDiff::Theta_v) = rho * l_comb * qvel(i,j,k) * SH;
+          K_turb(i,j,k,EddyDiff::QKE_v)   = rho * l_comb * qvel(i,j,k) * 3.0 * SQ;
+
+          K_turb(i,j,k,EddyDiff::PBL_lengthscale) = l_comb;
+      });
+    }
+}
+
+// A stably stratified, sheared state that is periodic in x and y (so the ghost cells filled
+//     here agree with their periodic images)
+static void
+fill_state (const Geometry& geom, MultiFab& cons, MultiFab& u, MultiFab& v)
+{
+    const Box& domain = geom.Domain();
+    const Real kx = 2.0 * PI / domain.length(0);
+    const Real ky = 2.0 * PI / domain.length(1);
+    const Real dz = geom.CellSize(2);
+
+    for (MFIter mfi(cons); mfi.isValid(); ++mfi) {
+        auto c_arr = cons.array(mfi);
+        auto u_arr = u.array(mfi);
+        auto v_arr = v.array(mfi);
+        ParallelFor(mfi.fabbox(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            const Real z = (k + 0.5) * dz;
+            const Real rho = 1.16 - 1.e-4 * z;
+            c_arr(i,j,k,Rho_comp)      = rho;
+            c_arr(i,j,k,RhoTheta_comp) = rho * (300.0 + 3.e-3 * z + 0.1 * std::sin(kx*i) * std::cos(ky*j));
+            c_arr(i,j,k,RhoKE_comp)    = 0.0;
+            c_arr(i,j,k,RhoQKE_comp)   = rho * (0.5 + 0.2 * std::sin(kx*i + ky*j) * std::exp(-z/500.0));
+            for (int n = RhoScalar_comp; n < NVAR; ++n) c_arr(i,j,k,n) = 0.0;
+        });
+        ParallelFor(u[mfi].box(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            u_arr(i,j,k) = 5.0 + 0.01 * (k + 0.5) * dz + 0.5 * std::cos(kx*i + ky*j);
+        });
+        ParallelFor(v[mfi].box(), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+            v_arr(i,j,k) = -1.0 + 2.e-3 * (k + 0.5) * dz + 0.3 * std::sin(kx*i - ky*j);
+        });
+    }
+}
+
+// Largest relative difference between a and b in the MYNN components, over the cells of b
+//     (and its ghost cells up to ng)
+static Real
+max_rel_diff (const MultiFab& a, const MultiFab& b, int ng)
+{
+    MultiFab diff(b.boxArray(), b.DistributionMap(), 1, ng);
+    diff.setVal(0.0);
+    const int comps[] = {EddyDiff::Mom_v, EddyDiff::Theta_v, EddyDiff::QKE_v, EddyDiff::PBL_lengthscale};
+    for (MFIter mfi(diff); mfi.isValid(); ++mfi) {
+        auto a_arr = a.const_array(mfi);
+        auto b_arr = b.const_array(mfi);
+        auto d_arr = diff.array(mfi);
+        for (int n : comps) {
+            ParallelFor(mfi.growntilebox(ng), [=] AMREX_GPU_DEVICE (int i, int j, int k) noexcept {
+                const Real err = std::abs(a_arr(i,j,k,n) - b_arr(i,j,k,n)) /
+                                 amrex::max(std::abs(a_arr(i,j,k,n)), Real(1.e-300));
+                d_arr(i,j,k) = amrex::max(d_arr(i,j,k), err);
+            });
+        }
+    }
+    return diff.norm0(0, ng);
+}
+
+bool
+test_mynn ()
+{
+    ParmParse pp("unit_test");
+    Vector<int> n_cell = {64, 64, 64};
+    pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+    int max_grid_size = 32;
+    pp.query("max_grid_size", max_grid_size);
+    int nrep = 20;
+    pp.query("nrep", nrep);
+
+    const Box domain(IntVect(0), IntVect(n_cell[0]-1, n_cell[1]-1, n_cell[2]-1));
+    const RealBox rb({0.,0.,0.}, {1000.,1000.,1000.});
+    const Array<int,AMREX_SPACEDIM> is_periodic{1,1,0};
+    const Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+    SolverChoice solverChoice;
+    solverChoice.pbl_type = PBLType::MYNN25;
+
+    std::unique_ptr<ABLMost> most = std::make_unique<ABLMost>(Vector<Geometry>{geom});
+    most->obukhov_len    = -100.0;
+    most->surf_temp_flux = 0.1;
+    most->theta_mean     = 300.0;
+
+    // The previous implementation needs grids, and tiles, that span the whole vertical domain
+    //     (as in the inputs that run the MYNN model, which set fabarray.mfiter_tile_size);
+    //     the new one is also run on grids split in the vertical
+    const IntVect tile_size_in = FabArrayBase::mfiter_tile_size;
+    FabArrayBase::mfiter_tile_size = IntVect(AMREX_D_DECL(1024000,8,1024000));
+
+    BoxArray ba_col(domain);
+    ba_col.maxSize(IntVect(AMREX_D_DECL(max_grid_size,max_grid_size,n_cell[2])));
+    const DistributionMapping dm_col(ba_col);
+
+    BoxArray ba_split(domain);
+    ba_split.maxSize(max_grid_size);
+    const DistributionMapping dm_split(ba_split);
+
+    const int ng = 3;
+    MultiFab cons_col(ba_col, dm_col, NVAR, ng);
+    MultiFab u_col(convert(ba_col, IntVect(1,0,0)), dm_col, 1, ng);
+    MultiFab v_col(convert(ba_col, IntVect(0,1,0)), dm_col, 1, ng);
+    fill_state(geom, cons_col, u_col, v_col);
+
+    MultiFab cons_split(ba_split, dm_split, NVAR, ng);
+    MultiFab u_split(convert(ba_split, IntVect(1,0,0)), dm_split, 1, ng);
+    MultiFab v_split(convert(ba_split, IntVect(0,1,0)), dm_split, 1, ng);
+    fill_state(geom, cons_split, u_split, v_split);
+
+    MultiFab K_ref(ba_col, dm_col, EddyDiff::NumDiffs, 1);
+    MultiFab K_col(ba_col, dm_col, EddyDiff::NumDiffs, 1);
+    MultiFab K_split(ba_split, dm_split, EddyDiff::NumDiffs, 1);
+    K_ref.setVal(0.0);
+    K_col.setVal(0.0);
+    K_split.setVal(0.0);
+
+    MYNNColumns cols_col(ba_col, dm_col, geom);
+    MYNNColumns cols_split(ba_split, dm_split, geom);
+
+    Real t_ref = 0.0, t_col = 0.0, t_split = 0.0;
+    for (int irep = 0; irep < nrep; ++irep)
+    {
+        Real t0 = amrex::second();
+        mynn_viscosity_per_tile(u_col, v_col, cons_col, K_ref, geom, solverChoice, most);
+        Gpu::streamSynchronize();
+        t_ref += amrex::second() - t0;
+
+        t0 = amrex::second();
+        ComputeTurbulentViscosityPBL(u_col, v_col, cons_col, K_col, geom, solverChoice, most,
+                                     &cols_col, false);
+        Gpu::streamSynchronize();
+        t_col += amrex::second() - t0;
+
+        t0 = amrex::second();
+        ComputeTurbulentViscosityPBL(u_split, v_split, cons_split, K_split, geom, solverChoice, most,
+                                     &cols_split, false);
+        Gpu::streamSynchronize();
+        t_split += amrex::second() - t0;
+    }
+
+    FabArrayBase::mfiter_tile_size = tile_size_in;
+
+    // Same grids: compare everywhere the model is evaluated, including the ghost cells.
+    //     Split grids: compare the valid cells on the full-column grids.
+    MultiFab K_split_on_col(ba_col, dm_col, EddyDiff::NumDiffs, 0);
+    K_split_on_col.ParallelCopy(K_split, 0, 0, EddyDiff::NumDiffs);
+
+    // The versions only differ in the order of the column sums
+    const Real err_col   = max_rel_diff(K_ref, K_col, 1);
+    const Real err_split = max_rel_diff(K_ref, K_split_on_col, 0);
+    const Real tol = 1.e4 * std::numeric_limits<Real>::epsilon();
+
+    amrex::Print() << "  " << domain.numPts() << " cells, " << nrep << " repetitions\n"
+                   << "  per-tile atomics (" << ba_col.size() << " full-column grids): "
+                   << t_ref/nrep << " s\n"
+                   << "  column sums      (" << ba_col.size() << " full-column grids): "
+                   << t_col/nrep << " s (speedup " << t_ref/t_col << "), max rel diff " << err_col << "\n"
+                   << "  column sums      (" << ba_split.size() << " grids split in z):   "
+                   << t_split/nrep << " s (speedup " << t_ref/t_split << "), max rel diff " << err_split
+                   << std::endl;
+
+    return (err_col <= tol && err_split <= tol);
+}
@@ -0,0 +1,82 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <AMReX_FArrayBox.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include "NCWpsFile.H"
+#include "UnitTests.H"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+// The serial element-by-element loop used before ConvertNCDataToFAB
+static void
+convert_by_element (const float* src, FArrayBox& fab)
+{
+    Real* dataPtr = fab.dataPtr();
+    for (Long n = 0; n < fab.box().numPts(); ++n) {
+        dataPtr[n] = static_cast<Real>(src[n]);
+    }
+}
+
+bool
+test_nc_to_fab ()
+{
+    ParmParse pp("unit_test");
+    Vector<int> n_cell = {256, 256, 64};
+    pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+    int nrep = 10;
+    pp.query("nrep", nrep);
+
+    const Box bx(IntVect(0), IntVect(n_cell[0]-1, n_cell[1]-1, n_cell[2]-1));
+    const Long npts = bx.numPts();
+
+    // Values of both signs spanning many decades, plus a few special ones
+    std::vector<float> src(npts);
+    for (Long n = 0; n < npts; ++n) {
+        src[n] = static_cast<float>(std::sin(0.37*n) * std::pow(10.0, static_cast<int>(n % 21) - 10));
+    }
+    src[0] = 0.0f;
+    src[npts/2] = -0.0f;
+    src[npts-1] = std::numeric_limits<float>::denorm_min();
+
+    // The readers convert into host FABs
+    FArrayBox fab_old(bx, 1, The_Pinned_Arena());
+    FArrayBox fab_new(bx, 1, The_Pinned_Arena());
+
+    Real t_old = 0.0;
+    Real t_new = 0.0;
+    for (int irep = 0; irep < nrep; ++irep)
+    {
+        Real t0 = amrex::second();
+        convert_by_element(src.data(), fab_old);
+        t_old += amrex::second() - t0;
+
+        t0 = amrex::second();
+        ConvertNCDataToFAB(src.data(), bx, fab_new, 0);
+        t_new += amrex::second() - t0;
+    }
+
+    const bool passed = (std::memcmp(fab_old.dataPtr(), fab_new.dataPtr(), npts*sizeof(Real)) == 0);
+
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    amrex::Print() << "  " << npts << " points, " << nthreads << " thread(s), " << nrep << " repetitions\n"
+                   << "  element loop       : " << t_old/nrep << " s per conversion\n"
+                   << "  ConvertNCDataToFAB : " << t_new/nrep << " s per conversion"
+                   << " (speedup " << t_old/t_new << ")\n"
+                   << "  results " << (passed ? "are" : "are NOT") << " bitwise identical" << std::endl;
+
+    return passed;
+}
@@ -0,0 +1,184 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <AMReX_Geometry.H>
+#include <AMReX_MultiFab.H>
+#include <AMReX_ParmParse.H>
+#include <AMReX_Print.H>
+#include <AMReX_Utility.H>
+
+#include "PlaneAverage.H"
+#include "VelPlaneAverage.H"
+#include "UnitTests.H"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace amrex;
+
+#ifndef AMREX_USE_GPU
+// The previous host path: the threads share the tiles and add every cell into the shared
+//     line storage with an atomic update
+static void
+plane_average_atomic (const MultiFab& mf, int ncell_plane, Vector<Real>& line_avg)
+{
+    const Real denom = 1.0 / static_cast<Real>(ncell_plane);
+    const int ncomp = mf.nComp();
+    Real* avg = line_avg.data();
+    std::fill(line_avg.begin(), line_avg.end(), 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(mf, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        const Box bx = mfi.tilebox();
+        auto fab_arr = mf.const_array(mfi);
+        for (int n = 0; n < ncomp; ++n) {
+            LoopOnCpu(bx, [=] (int i, int j, int k) noexcept {
+#ifdef _OPENMP
+#pragma omp atomic update
+#endif
+                avg[ncomp * k + n] += fab_arr(i, j, k, n) * denom;
+            });
+        }
+    }
+    ParallelDescriptor::ReduceRealSum(line_avg.data(), line_avg.size());
+}
+
+static void
+hvelmag_average_atomic (const MultiFab& u_mf, const MultiFab& v_mf, int ncell_plane, int nz,
+                        Vector<Real>& line_avg)
+{
+    Real* avg = line_avg.data();
+    std::fill(line_avg.begin(), line_avg.end(), 0.0);
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    for (MFIter mfi(u_mf, TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+        Box bx = enclosedCells(mfi.tilebox());
+        bx.setSmall(2, 0);
+        bx.setBig(2, nz-2);
+        auto u_arr = u_mf.const_array(mfi);
+        auto v_arr = v_mf.const_array(mfi);
+        LoopOnCpu(bx, [=] (int i, int j, int k) noexcept {
+            const Real xvel = 0.5 * (u_arr(i,j,k) + u_arr(i+1,j,k));
+            const Real yvel = 0.5 * (v_arr(i,j,k) + v_arr(i,j+1,k));
+#ifdef _OPENMP
+#pragma omp atomic update
+#endif
+            avg[k] += std::sqrt(xvel*xvel + yvel*yvel);
+        });
+    }
+    for (int k = 0; k < nz-1; ++k) {
+        line_avg[k] /= static_cast<Real>(ncell_plane);
+    }
+    ParallelDescriptor::ReduceRealSum(line_avg.data(), line_avg.size());
+}
+
+static Real
+max_rel_diff (const Vector<Real>& a, const Vector<Real>& b)
+{
+    Real err = 0.0;
+    for (int n = 0; n < a.size(); ++n) {
+        err = amrex::max(err, std::abs(a[n] - b[n]) / amrex::max(std::abs(a[n]), Real(1.e-300)));
+    }
+    return err;
+}
+#endif
+
+bool
+test_plane_average ()
+{
+#ifdef AMREX_USE_GPU
+    amrex::Print() << "  The plane average benchmark compares the host paths; nothing to do on GPUs" << std::endl;
+    return true;
+#else
+    ParmParse pp("unit_test");
+    Vector<int> n_cell = {128, 128, 128};
+    pp.queryarr("n_cell", n_cell, 0, AMREX_SPACEDIM);
+    int max_grid_size = 64;
+    pp.query("max_grid_size", max_grid_size);
+    int nrep = 20;
+    pp.query("nrep", nrep);
+    const int ncomp = 4;
+
+    const Box domain(IntVect(0), IntVect(n_cell[0]-1, n_cell[1]-1, n_cell[2]-1));
+    const RealBox rb({0.,0.,0.}, {1.,1.,1.});
+    const Array<int,AMREX_SPACEDIM> is_periodic{1,1,0};
+    const Geometry geom(domain, rb, CoordSys::cartesian, is_periodic);
+
+    BoxArray ba(domain);
+    ba.maxSize(max_grid_size);
+    const DistributionMapping dm(ba);
+
+    MultiFab cc(ba, dm, ncomp, 0);
+    MultiFab u(convert(ba, IntVect(1,0,0)), dm, 1, 0);
+    MultiFab v(convert(ba, IntVect(0,1,0)), dm, 1, 0);
+
+    for (MFIter mfi(cc); mfi.isValid(); ++mfi) {
+        auto c_arr = cc.array(mfi);
+        auto u_arr = u.array(mfi);
+        auto v_arr = v.array(mfi);
+        ParallelFor(mfi.fabbox(), ncomp, [=] (int i, int j, int k, int n) noexcept {
+            c_arr(i,j,k,n) = 1.0 + n + std::sin(0.1*i + 0.2*j + 0.3*k + n);
+        });
+        ParallelFor(u.box(mfi.index()), [=] (int i, int j, int k) noexcept {
+            u_arr(i,j,k) = 5.0 + std::cos(0.1*i - 0.05*j + 0.02*k);
+        });
+        ParallelFor(v.box(mfi.index()), [=] (int i, int j, int k) noexcept {
+            v_arr(i,j,k) = -2.0 + std::sin(0.07*i + 0.13*j - 0.01*k);
+        });
+    }
+
+    const int nz = n_cell[2];
+    const int ncell_plane = n_cell[0] * n_cell[1];
+
+    PlaneAverage pavg(&cc, geom, 2);
+    VelPlaneAverage vavg(geom);
+    Vector<Real> atomic_avg(pavg.line_average().size());
+    Vector<Real> atomic_hvel(vavg.line_hvelmag_average().size());
+
+    Real t_atomic = 0.0, t_buffer = 0.0, t_hvel_atomic = 0.0, t_hvel_buffer = 0.0;
+    for (int irep = 0; irep < nrep; ++irep)
+    {
+        Real t0 = amrex::second();
+        plane_average_atomic(cc, ncell_plane, atomic_avg);
+        t_atomic += amrex::second() - t0;
+
+        t0 = amrex::second();
+        pavg();
+        t_buffer += amrex::second() - t0;
+
+        t0 = amrex::second();
+        hvelmag_average_atomic(u, v, ncell_plane, nz, atomic_hvel);
+        t_hvel_atomic += amrex::second() - t0;
+
+        t0 = amrex::second();
+        vavg.compute_hvelmag_averages(u, v);
+        t_hvel_buffer += amrex::second() - t0;
+    }
+
+    // The two paths only differ in the order of the sums
+    const Real err      = max_rel_diff(atomic_avg , pavg.line_average());
+    const Real err_hvel = max_rel_diff(atomic_hvel, vavg.line_hvelmag_average());
+    const Real tol = 1.e4 * std::numeric_limits<Real>::epsilon();
+
+#ifdef _OPENMP
+    const int nthreads = omp_get_max_threads();
+#else
+    const int nthreads = 1;
+#endif
+    amrex::Print() << "  " << domain.numPts() << " cells in " << ba.size() << " grids, "
+                   << nthreads << " thread(s), " << nrep << " repetitions\n"
+                   << "  PlaneAverage    atomic: " << t_atomic/nrep << " s, per-thread buffers: "
+                   << t_buffer/nrep << " s (speedup " << t_atomic/t_buffer << "), max rel diff " << err << "\n"
+                   << "  VelPlaneAverage atomic: " << t_hvel_atomic/nrep << " s, per-thread buffers: "
+                   << t_hvel_buffer/nrep << " s (speedup " << t_hvel_atomic/t_hvel_buffer << "), max rel diff "
+                   << err_hvel << std::endl;
+
+    return (err <= tol && err_hvel <= tol);
+#endif
+}